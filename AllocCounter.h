@@ -0,0 +1,5 @@
+#pragma once
+
+// Counts every heap allocation made through the global operator new. Only the command-line
+// tools link AllocCounter.cpp; the game itself keeps the default allocator.
+unsigned long long heapAllocations();
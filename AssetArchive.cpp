@@ -0,0 +1,116 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+// File layout, native little-endian:
+//   "BJPK", u32 version, u32 entry count, u32 reserved, then the ArchiveEntry index,
+//   then each asset's bytes at its 16-byte aligned offset
+static const char ARCHIVE_MAGIC[4] = { 'B', 'J', 'P', 'K' };
+static const std::uint32_t ARCHIVE_VERSION = 1;
+static const std::uint64_t ARCHIVE_ALIGNMENT = 16;
+
+struct ArchiveHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+AssetArchive::AssetArchive() : entries(nullptr), count(0) {}
+
+bool AssetArchive::open(const std::string& path) {
+    close();
+    if (!file.openRead(path)) {
+        return false;
+    }
+    const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(file.data());
+    if (file.size() < sizeof(ArchiveHeader) || std::memcmp(header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0
+        || header->version != ARCHIVE_VERSION || header->count > (file.size() - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry)) {
+        std::cerr << path << " is not a version " << ARCHIVE_VERSION << " asset archive" << std::endl;
+        file.close();
+        return false;
+    }
+    const ArchiveEntry* index = reinterpret_cast<const ArchiveEntry*>(file.data() + sizeof(ArchiveHeader));
+    for (std::uint32_t i = 0; i < header->count; ++i) {
+        if (index[i].name[sizeof(index[i].name) - 1] != '\0' || index[i].offset > file.size() || index[i].size > file.size() - index[i].offset) {
+            std::cerr << "Asset archive " << path << " is truncated" << std::endl;
+            file.close();
+            return false;
+        }
+    }
+    entries = index;
+    count = static_cast<int>(header->count);
+    return true;
+}
+
+void AssetArchive::close() {
+    file.close();
+    entries = nullptr;
+    count = 0;
+}
+
+const void* AssetArchive::find(const std::string& name, std::size_t& size) const {
+    size = 0;
+    const ArchiveEntry* end = entries + count;
+    const ArchiveEntry* found = std::lower_bound(entries, end, name, [](const ArchiveEntry& entry, const std::string& key) {
+        return std::strcmp(entry.name, key.c_str()) < 0;
+    });
+    if (found == end || name != found->name) {
+        return nullptr;
+    }
+    size = static_cast<std::size_t>(found->size);
+    return file.data() + found->offset;
+}
+
+bool packArchive(const std::string& path, const std::vector<std::string>& files) {
+    std::vector<std::string> names(files);
+    std::sort(names.begin(), names.end());
+
+    std::vector<std::vector<char>> contents;
+    std::vector<ArchiveEntry> index(names.size());
+    std::uint64_t offset = sizeof(ArchiveHeader) + names.size() * sizeof(ArchiveEntry);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (names[i].size() >= sizeof(index[i].name)) {
+            std::cerr << "Asset name " << names[i] << " is too long to pack" << std::endl;
+            return false;
+        }
+        std::ifstream in(names[i], std::ios::binary);
+        if (!in) {
+            std::cerr << "Failed to open asset " << names[i] << std::endl;
+            return false;
+        }
+        contents.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        std::memset(&index[i], 0, sizeof(index[i]));
+        std::memcpy(index[i].name, names[i].c_str(), names[i].size());
+        offset = (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+        index[i].offset = offset;
+        index[i].size = contents.back().size();
+        offset += index[i].size;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to write asset archive " << path << std::endl;
+        return false;
+    }
+    ArchiveHeader header;
+    std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    header.version = ARCHIVE_VERSION;
+    header.count = static_cast<std::uint32_t>(index.size());
+    header.reserved = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(ArchiveEntry));
+    std::uint64_t written = sizeof(ArchiveHeader) + index.size() * sizeof(ArchiveEntry);
+    for (std::size_t i = 0; i < index.size(); ++i) {
+        for (; written < index[i].offset; ++written) {
+            out.put('\0');
+        }
+        out.write(contents[i].data(), contents[i].size());
+        written += contents[i].size();
+    }
+    return static_cast<bool>(out);
+}
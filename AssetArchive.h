@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Storage.h"
+
+// All game assets in one file, so a cold start opens one file instead of one per asset.
+// The archive is memory-mapped and its index is read in place; find() hands out pointers
+// straight into the mapping, which stay valid for as long as the archive is open.
+
+struct ArchiveEntry {
+    char name[48];          // Zero-terminated; entries are sorted by name
+    std::uint64_t offset;   // From the start of the archive, 16-byte aligned
+    std::uint64_t size;
+};
+
+static_assert(sizeof(ArchiveEntry) == 64, "ArchiveEntry is stored as is");
+
+class AssetArchive {
+public:
+    AssetArchive();
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const {
+        return entries != nullptr;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    const ArchiveEntry& entry(int i) const {
+        return entries[i];
+    }
+
+    // Bytes stored under name, or null (and size 0) if the archive has no such asset
+    const void* find(const std::string& name, std::size_t& size) const;
+
+private:
+    MappedFile file;
+    const ArchiveEntry* entries;
+    int count;
+};
+
+// Writes the files into a new archive at path, each under the name it was given by
+bool packArchive(const std::string& path, const std::vector<std::string>& files);
@@ -0,0 +1,46 @@
+#include "BatchGeometry.h"
+#include <cmath>
+
+void appendQuad(std::vector<BatchVertex>& vertices, BatchPoint position, BatchPoint size,
+    BatchPoint origin, float rotation, BatchColor color, BatchTextureRect textureRect) {
+    const float radians = rotation * 3.14159265f / 180.f;
+    const float cosine = std::cos(radians);
+    const float sine = std::sin(radians);
+
+    // Corners relative to the origin, rotated about it, then moved to position
+    BatchPoint corners[4] = {
+        { -origin.x, -origin.y },
+        { size.x - origin.x, -origin.y },
+        { size.x - origin.x, size.y - origin.y },
+        { -origin.x, size.y - origin.y }
+    };
+    const BatchPoint texCoords[4] = {
+        { textureRect.left, textureRect.top },
+        { textureRect.left + textureRect.width, textureRect.top },
+        { textureRect.left + textureRect.width, textureRect.top + textureRect.height },
+        { textureRect.left, textureRect.top + textureRect.height }
+    };
+    for (auto& corner : corners) {
+        corner = BatchPoint{ position.x + corner.x * cosine - corner.y * sine,
+            position.y + corner.x * sine + corner.y * cosine };
+    }
+
+    const int order[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int index : order) {
+        vertices.push_back(BatchVertex{ corners[index], color, texCoords[index] });
+    }
+}
+
+void appendCircle(std::vector<BatchVertex>& vertices, BatchPoint position, float radius,
+    BatchColor color, unsigned int pointCount) {
+    const BatchPoint center = { position.x + radius, position.y + radius };
+    const BatchPoint none = { 0, 0 };
+    const float step = 2 * 3.14159265f / pointCount;
+    for (unsigned int i = 0; i < pointCount; ++i) {
+        float from = step * i;
+        float to = step * (i + 1);
+        vertices.push_back(BatchVertex{ center, color, none });
+        vertices.push_back(BatchVertex{ { center.x + radius * std::cos(from), center.y + radius * std::sin(from) }, color, none });
+        vertices.push_back(BatchVertex{ { center.x + radius * std::cos(to), center.y + radius * std::sin(to) }, color, none });
+    }
+}
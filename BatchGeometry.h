@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Vertex generation for SpriteBatch, kept free of SFML so it builds into the headless core
+// and can be checked without a window (bunny_sim --check-geometry). BatchVertex has the
+// layout of sf::Vertex, so the batcher hands its arrays to SFML without converting them.
+
+struct BatchPoint {
+    float x;
+    float y;
+};
+
+struct BatchColor {
+    std::uint8_t r;
+    std::uint8_t g;
+    std::uint8_t b;
+    std::uint8_t a;
+};
+
+struct BatchVertex {
+    BatchPoint position;
+    BatchColor color;
+    BatchPoint texCoords;
+};
+
+// Texture area in pixels; the default leaves every texture coordinate at zero
+struct BatchTextureRect {
+    float left;
+    float top;
+    float width;
+    float height;
+};
+
+// Appends a rotated, optionally textured rectangle as two triangles (6 vertices).
+// origin is relative to the top-left corner, like sf::Transformable::setOrigin; rotation is
+// in degrees, clockwise on screen. Both triangles wind the same way as appendCircle's.
+void appendQuad(std::vector<BatchVertex>& vertices, BatchPoint position, BatchPoint size,
+    BatchPoint origin, float rotation, BatchColor color, BatchTextureRect textureRect = BatchTextureRect());
+
+// Appends a filled circle whose bounding box starts at position, as pointCount triangles
+void appendCircle(std::vector<BatchVertex>& vertices, BatchPoint position, float radius,
+    BatchColor color, unsigned int pointCount = 24);
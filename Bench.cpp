@@ -0,0 +1,366 @@
+// Microbenchmarks for the game loop hot paths at scaled entity counts. Every row reports
+// the best-of-five ns per operation and the heap allocations per operation, one row per line
+// in a fixed order, so two runs can be diffed or compared directly:
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   build/bunny_bench > before.txt
+//   ... change something, rebuild ...
+//   build/bunny_bench --compare before.txt
+//
+// --compare exits non-zero if any row got slower by more than --threshold percent
+// (default 10) or started allocating more. Configure with -DBUNNY_AVX=ON to measure the
+// saucer rows with the AVX kernel; the header names the kernel that was built.
+#include "GameWorld.h"
+#include "AllocCounter.h"
+#include "Bot.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+constexpr int SCALES[] = { 10, 1000, 100000 };
+
+// Collision results are added here so the optimiser cannot drop the work that found them
+volatile long long benchSink = 0;
+
+struct BenchResult {
+    std::string name;
+    int count;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+struct BenchOptions {
+    double minSeconds;   // Time spent on each row, split across the samples
+    const char* filter;  // Only rows whose name contains this
+};
+
+// Calls body() (which performs opsPerCall operations) after one warm-up call, in five
+// samples of at least minSeconds / 5 each, and reports the fastest. Interference from the
+// rest of the machine only ever adds time, so the fastest sample is the most repeatable.
+template <typename Body>
+BenchResult measure(const BenchOptions& options, const char* name, int count, long long opsPerCall, Body body) {
+    body();
+
+    const int samples = 5;
+    double nsPerOp[samples];
+    unsigned long long allocations = 0;
+    long long ops = 0;
+    for (int sample = 0; sample < samples; ++sample) {
+        long long calls = 0;
+        double seconds = 0;
+        unsigned long long before = heapAllocations();
+        auto start = std::chrono::steady_clock::now();
+        do {
+            body();
+            calls++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < options.minSeconds / samples);
+        allocations += heapAllocations() - before;
+        ops += calls * opsPerCall;
+        nsPerOp[sample] = seconds * 1e9 / (calls * opsPerCall);
+    }
+    return BenchResult{ name, count, *std::min_element(nsPerOp, nsPerOp + samples), double(allocations) / ops };
+}
+
+// A grid sized the way the game sizes its own, with enough buckets that count entities
+// spread up a column do not all pile into the same few
+SpatialGrid gridFor(int count) {
+    int buckets = 256;
+    while (buckets < count / 4) {
+        buckets *= 2;
+    }
+    return SpatialGrid(128.f, buckets);
+}
+
+// Bunny::update for count independent bunnies, one op per bunny
+BenchResult benchBunnyUpdate(const BenchOptions& options, int count) {
+    std::vector<Bunny> bunnies(count, Bunny(375, 300));
+    GameConfig config;
+    InputState input;
+    input.jump = true;
+    input.right = true;
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    return measure(options, "bunny_update", count, count, [&]() {
+        for (Bunny& bunny : bunnies) {
+            bunny.update(config, true, input, deltaTime);
+            bunny.position = Vec2(375, 300); // Keep them on screen so nothing drifts to infinity
+        }
+    });
+}
+
+// SaucerField::update over count saucers, one op per saucer
+BenchResult benchSaucerUpdate(const BenchOptions& options, int count) {
+    SaucerField saucers(count);
+    RandomStream random(1);
+    for (int i = 0; i < count; ++i) {
+        float x = random.uniform(0, WORLD_WIDTH - 100);
+        saucers.add(x, -100.f * i, 100, 20, random.uniform(10, 400));
+    }
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    return measure(options, "saucer_update", count, count, [&]() {
+        saucers.update(deltaTime, WORLD_WIDTH);
+    });
+}
+
+// One bunny-sized broadphase query plus narrowphase against count coins spread up a
+// column, one op per query
+BenchResult benchCoinCollision(const BenchOptions& options, int count) {
+    RandomStream random(2);
+    const float columnHeight = count * 10.f;
+    std::vector<Coin> coins;
+    SpatialGrid grid = gridFor(count);
+    for (int i = 0; i < count; ++i) {
+        float x = random.uniform(0, WORLD_WIDTH - 30);
+        coins.emplace_back(x, random.uniform(-columnHeight, WORLD_HEIGHT));
+        grid.insert(i, coins[i].position.y, Coin::RADIUS * 2);
+    }
+    std::vector<Rect> probes;
+    for (int i = 0; i < 256; ++i) {
+        float x = random.uniform(0, WORLD_WIDTH - BUNNY_SIZE);
+        probes.push_back(Rect(x, random.uniform(-columnHeight, WORLD_HEIGHT), BUNNY_SIZE, BUNNY_SIZE));
+    }
+    std::vector<int> nearby;
+    nearby.reserve(64);
+    return measure(options, "coin_collision", count, static_cast<long long>(probes.size()), [&]() {
+        for (const Rect& probe : probes) {
+            grid.query(probe.top, probe.top + probe.height, nearby);
+            for (int index : nearby) {
+                benchSink += coins[index].checkCollision(probe) ? 1 : 0;
+            }
+        }
+    });
+}
+
+// The landing test: one bunny-sized query against count saucers stacked 100 px apart,
+// as the game spawns them, one op per query
+BenchResult benchSaucerCollision(const BenchOptions& options, int count) {
+    RandomStream random(3);
+    SaucerField saucers(count);
+    SpatialGrid grid = gridFor(count);
+    for (int i = 0; i < count; ++i) {
+        int serial = saucers.add(random.uniform(100, 700), 500 - 100.f * i, 100, 20);
+        grid.insert(serial, saucers.y[saucers.slot(serial)] - POWER_UP_REACH, POWER_UP_REACH + 20);
+    }
+    const float columnHeight = count * 100.f;
+    std::vector<Rect> probes;
+    for (int i = 0; i < 256; ++i) {
+        float x = random.uniform(0, WORLD_WIDTH - BUNNY_SIZE);
+        probes.push_back(Rect(x, random.uniform(-columnHeight, WORLD_HEIGHT), BUNNY_SIZE, BUNNY_SIZE));
+    }
+    std::vector<int> nearby;
+    nearby.reserve(64);
+    return measure(options, "saucer_collision", count, static_cast<long long>(probes.size()), [&]() {
+        for (const Rect& probe : probes) {
+            grid.query(probe.top, probe.top + probe.height, nearby);
+            for (int serial : nearby) {
+                int i = saucers.slot(serial);
+                benchSink += probe.intersects(Rect(saucers.x[i], saucers.y[i], saucers.width[i], saucers.height[i])) ? 1 : 0;
+            }
+        }
+    });
+}
+
+// Spawning a saucer at the top of a full ring and culling the oldest, with their grid
+// entries, one op per spawn and cull. The ring rounds count up to a power of two, so the
+// row is labelled with the number of saucers it actually holds.
+BenchResult benchSaucerSpawnCull(const BenchOptions& options, int count) {
+    RandomStream random(4);
+    SaucerField saucers(count);
+    SpatialGrid grid = gridFor(count);
+    float top = 500;
+    auto spawn = [&]() {
+        int serial = saucers.add(random.uniform(100, 700), top, 100, 20);
+        grid.insert(serial, top - POWER_UP_REACH, POWER_UP_REACH + 20);
+        top -= 100;
+    };
+    while (!saucers.full()) {
+        spawn();
+    }
+    return measure(options, "saucer_spawn_cull", saucers.capacity(), 64, [&]() {
+        for (int i = 0; i < 64; ++i) {
+            int oldest = saucers.slot(saucers.head);
+            grid.remove(saucers.head, saucers.y[oldest] - POWER_UP_REACH);
+            saucers.popFront();
+            spawn();
+        }
+    });
+}
+
+// Acquiring and releasing coins in a pool holding Capacity of them, one op per pair
+template <int Capacity>
+BenchResult benchCoinSpawnCull(const BenchOptions& options) {
+    std::unique_ptr<Pool<Coin, Capacity>> coins(new Pool<Coin, Capacity>());
+    RandomStream random(5);
+    while (coins->acquire() >= 0) {
+    }
+    return measure(options, "coin_spawn_cull", Capacity, 64, [&]() {
+        for (int i = 0; i < 64; ++i) {
+            int slot = random.range(0, Capacity - 1);
+            coins->release(slot);
+            slot = coins->acquire();
+            (*coins)[slot] = Coin(random.uniform(0, WORLD_WIDTH - 30), 0);
+        }
+    });
+}
+
+// Advancing a TimerWheel holding Capacity timers due within ten seconds, each rescheduling
+// itself as it fires, one op per tick
+template <int Capacity>
+BenchResult benchTimerWheel(const BenchOptions& options) {
+    std::unique_ptr<TimerWheel<Capacity>> timers(new TimerWheel<Capacity>());
+    RandomStream random(6);
+    const int horizon = 10 * static_cast<int>(SIM_TICK_RATE);
+    for (int id = 0; id < Capacity; ++id) {
+        timers->schedule(id, random.range(1, horizon));
+    }
+    return measure(options, "timer_wheel", Capacity, 64, [&]() {
+        for (int tick = 0; tick < 64; ++tick) {
+            timers->advance([&](int id) {
+                timers->schedule(id, random.range(1, horizon));
+            });
+        }
+    });
+}
+
+// Saving a WorldSnapshot of a game in progress and restoring it, one op per pair
+BenchResult benchSnapshot(const BenchOptions& options) {
+    GameWorld world(1);
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    for (int tick = 0; tick < 20 * static_cast<int>(SIM_TICK_RATE) && !world.gameOver; ++tick) {
+        world.step(botInput(world), deltaTime);
+    }
+    std::unique_ptr<WorldSnapshot> snapshot(new WorldSnapshot());
+    return measure(options, "snapshot_restore", 1, 1, [&]() {
+        world.save(*snapshot);
+        world.restore(*snapshot);
+    });
+}
+
+// Whole GameWorld::step ticks driven by the bot, at the game's own entity budgets
+BenchResult benchWorldStep(const BenchOptions& options) {
+    GameWorld world(1);
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    return measure(options, "world_step", 1, 120, [&]() {
+        for (int tick = 0; tick < 120; ++tick) {
+            if (world.gameOver) {
+                world.reset();
+            }
+            world.step(botInput(world), deltaTime);
+        }
+    });
+}
+
+std::vector<BenchResult> runAll(const BenchOptions& options) {
+    std::vector<BenchResult> results;
+    auto wanted = [&](const char* name) {
+        return !options.filter || std::strstr(name, options.filter);
+    };
+    for (int count : SCALES) {
+        if (wanted("bunny_update")) results.push_back(benchBunnyUpdate(options, count));
+        if (wanted("saucer_update")) results.push_back(benchSaucerUpdate(options, count));
+        if (wanted("coin_collision")) results.push_back(benchCoinCollision(options, count));
+        if (wanted("saucer_collision")) results.push_back(benchSaucerCollision(options, count));
+        if (wanted("saucer_spawn_cull")) results.push_back(benchSaucerSpawnCull(options, count));
+    }
+    if (wanted("coin_spawn_cull")) {
+        results.push_back(benchCoinSpawnCull<SCALES[0]>(options));
+        results.push_back(benchCoinSpawnCull<SCALES[1]>(options));
+        results.push_back(benchCoinSpawnCull<SCALES[2]>(options));
+    }
+    if (wanted("timer_wheel")) {
+        results.push_back(benchTimerWheel<SCALES[0]>(options));
+        results.push_back(benchTimerWheel<SCALES[1]>(options));
+        results.push_back(benchTimerWheel<SCALES[2]>(options));
+    }
+    if (wanted("snapshot_restore")) results.push_back(benchSnapshot(options));
+    if (wanted("world_step")) results.push_back(benchWorldStep(options));
+    return results;
+}
+
+// Reads rows written by an earlier run, keyed by "name count"
+std::map<std::string, BenchResult> loadResults(const char* path) {
+    std::map<std::string, BenchResult> results;
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "Failed to open %s\n", path);
+        return results;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        BenchResult result;
+        if (fields >> result.name >> result.count >> result.nsPerOp >> result.allocsPerOp) {
+            results[result.name + " " + std::to_string(result.count)] = result;
+        }
+    }
+    return results;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    options.minSeconds = 0.25;
+    options.filter = nullptr;
+    const char* comparePath = nullptr;
+    double threshold = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minSeconds = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+            comparePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        }
+        else {
+            std::fprintf(stderr, "Usage: %s [--min-time SECONDS] [--filter NAME] [--compare FILE [--threshold PERCENT]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::map<std::string, BenchResult> baseline;
+    if (comparePath) {
+        baseline = loadResults(comparePath);
+        if (baseline.empty()) {
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results = runAll(options);
+
+    int regressions = 0;
+    std::printf("# saucer kernel: %s\n", saucerKernelName());
+    std::printf("# %-18s %8s %12s %10s%s\n", "benchmark", "count", "ns/op", "allocs/op", comparePath ? "      change" : "");
+    for (const BenchResult& result : results) {
+        std::printf("%-20s %8d %12.2f %10.3f", result.name.c_str(), result.count, result.nsPerOp, result.allocsPerOp);
+        auto base = baseline.find(result.name + " " + std::to_string(result.count));
+        if (base != baseline.end()) {
+            double change = (result.nsPerOp / base->second.nsPerOp - 1) * 100;
+            bool slower = change > threshold;
+            bool allocates = result.allocsPerOp > base->second.allocsPerOp + 1e-9;
+            std::printf("  %+9.1f%%%s", change, slower || allocates ? (allocates ? "  ALLOCS" : "  SLOWER") : "");
+            regressions += slower || allocates ? 1 : 0;
+        }
+        std::printf("\n");
+    }
+    if (regressions > 0) {
+        std::fprintf(stderr, "%d of %d rows regressed against %s\n", regressions, static_cast<int>(results.size()), comparePath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "GameWorld.h"
+
+// Scripted player for the headless tools. Good enough to climb for a while, which makes
+// its runs a steady, repeatable workload.
+
+// Always holds jump and steers towards the nearest saucer above the bunny
+inline InputState botInput(const GameWorld& world) {
+    InputState input;
+    input.jump = true;
+
+    const SaucerField& saucers = world.saucers;
+    int target = -1;
+    float feet = world.bunny.position.y + BUNNY_SIZE;
+    for (int serial = saucers.head; serial != saucers.tail; ++serial) {
+        int i = saucers.slot(serial);
+        if (saucers.y[i] < feet - 1 && (target < 0 || saucers.y[i] > saucers.y[target])) {
+            target = i;
+        }
+    }
+    if (target >= 0) {
+        float bunnyCenter = world.bunny.position.x + BUNNY_SIZE / 2;
+        float saucerCenter = saucers.x[target] + saucers.width[target] / 2;
+        input.left = bunnyCenter > saucerCenter + 10;
+        input.right = bunnyCenter < saucerCenter - 10;
+    }
+    return input;
+}
+
+// Tries holding left, right and neither for horizon ticks from the current state and
+// returns whichever ends with the bunny highest, always holding jump. The world is
+// restored to where it was before returning; start is scratch space for the snapshot.
+inline InputState lookaheadBotInput(GameWorld& world, WorldSnapshot& start, float deltaTime, int horizon = 60) {
+    Logger* logger = world.logger;
+    Profiler* profiler = world.profiler;
+    world.logger = nullptr; // Futures that are thrown away should not be logged or timed
+    world.profiler = nullptr;
+    world.save(start);
+
+    InputState best;
+    float bestHeight = 0;
+    for (int candidate = 0; candidate < 3; ++candidate) {
+        InputState input;
+        input.jump = true;
+        input.left = candidate == 1;
+        input.right = candidate == 2;
+        for (int tick = 0; tick < horizon && !world.gameOver; ++tick) {
+            world.step(input, deltaTime);
+        }
+        float height = world.gameOver ? -WORLD_HEIGHT : world.currentHeight();
+        if (candidate == 0 || height > bestHeight) {
+            best = input;
+            bestHeight = height;
+        }
+        world.restore(start);
+    }
+
+    world.logger = logger;
+    world.profiler = profiler;
+    return best;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Accumulates real frame time and hands it out as whole simulation ticks, so the
+// world always advances in steps of exactly tickDuration regardless of frame rate.
+class FixedTimestep {
+public:
+    float tickDuration;     // Seconds per simulation tick
+    int maxTicksPerFrame;   // Cap so a long stall does not snowball into ever longer frames
+    float accumulator;      // Real time not yet consumed by a tick
+
+    explicit FixedTimestep(float tickRate, int maxTicksPerFrame = 8)
+        : tickDuration(1.f / tickRate), maxTicksPerFrame(maxTicksPerFrame), accumulator(0) {}
+
+    // Adds a frame's elapsed time and returns how many ticks should be simulated now
+    int advance(float frameTime) {
+        accumulator += frameTime;
+        int ticks = static_cast<int>(accumulator / tickDuration);
+        if (ticks > maxTicksPerFrame) {
+            ticks = maxTicksPerFrame;
+            accumulator = 0; // Drop the backlog rather than trying to catch up
+        }
+        else {
+            accumulator -= ticks * tickDuration;
+        }
+        return ticks;
+    }
+
+    // How far between the previous and the current tick the rendered frame lies (0..1)
+    float alpha() const {
+        return accumulator / tickDuration;
+    }
+
+    void reset() {
+        accumulator = 0;
+    }
+};
@@ -0,0 +1,128 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+// Bounds on the spin margin: below the lower one a sleep is as good as a spin, and a
+// scheduler coarser than the upper one is not worth sleeping on at all
+static const std::chrono::microseconds MIN_SPIN_MARGIN(200);
+static const std::chrono::microseconds MAX_SPIN_MARGIN(4000);
+
+FramePacer::FramePacer(float framesPerSecond)
+    : framesPerSecond(0), period(0), started(false), spinMargin(std::chrono::microseconds(1000)),
+    intervals(CAPACITY), frames(0), late(0), slept(0), spun(0) {
+    scratch.reserve(CAPACITY);
+#ifdef _WIN32
+    timeBeginPeriod(1); // Millisecond sleeps instead of the default 15.6 ms scheduler tick
+#endif
+    setRate(framesPerSecond);
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::setRate(float rate) {
+    framesPerSecond = rate > 0 ? rate : 0;
+    period = framesPerSecond > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond))
+        : Clock::duration(0);
+    restart();
+}
+
+void FramePacer::restart() {
+    started = false;
+}
+
+void FramePacer::wait() {
+    Clock::time_point now = Clock::now();
+    if (!started) {
+        started = true;
+        deadline = now + period;
+        lastFrame = now;
+        return;
+    }
+
+    if (period > Clock::duration(0)) {
+        if (now < deadline) {
+            Clock::time_point wake = deadline - spinMargin;
+            if (now < wake) {
+                std::this_thread::sleep_until(wake);
+                Clock::time_point woke = Clock::now();
+                slept += std::chrono::duration_cast<std::chrono::nanoseconds>(woke - now).count();
+
+                // Overslept into the margin: widen it; woke with room to spare: narrow it slowly
+                Clock::duration overshoot = woke - wake;
+                if (overshoot > spinMargin / 2) {
+                    spinMargin = std::min<Clock::duration>(spinMargin + overshoot, MAX_SPIN_MARGIN);
+                }
+                else {
+                    spinMargin = std::max<Clock::duration>(spinMargin - spinMargin / 16, MIN_SPIN_MARGIN);
+                }
+                now = woke;
+            }
+            Clock::time_point spinStart = now;
+            while (now < deadline) {
+                now = Clock::now();
+            }
+            spun += std::chrono::duration_cast<std::chrono::nanoseconds>(now - spinStart).count();
+        }
+        if (now > deadline + std::chrono::milliseconds(1)) {
+            late++;
+        }
+
+        // Frames are due on a fixed grid so small delays do not add up; after a real
+        // stall the grid starts over rather than rushing frames out to catch up
+        deadline += period;
+        if (deadline < now) {
+            deadline = now + period;
+        }
+    }
+
+    intervals[frames % CAPACITY] = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastFrame).count();
+    frames++;
+    lastFrame = now;
+}
+
+FrameTimeStats FramePacer::stats() const {
+    FrameTimeStats stats;
+    stats.count = static_cast<int>(std::min<std::uint64_t>(frames, CAPACITY));
+    stats.mean = stats.p50 = stats.p99 = stats.max = 0;
+    stats.late = late;
+    stats.sleptFraction = slept + spun > 0 ? double(slept) / (slept + spun) : 0;
+    if (stats.count == 0) {
+        return stats;
+    }
+
+    scratch.assign(intervals.begin(), intervals.begin() + stats.count);
+    std::sort(scratch.begin(), scratch.end());
+    double total = 0;
+    for (std::int64_t interval : scratch) {
+        total += interval;
+    }
+    stats.mean = total / stats.count / 1e6;
+    stats.p50 = scratch[(stats.count - 1) / 2] / 1e6;
+    stats.p99 = scratch[static_cast<std::size_t>(0.99 * (stats.count - 1))] / 1e6;
+    stats.max = scratch.back() / 1e6;
+    return stats;
+}
+
+void FramePacer::printStats(std::ostream& out) const {
+    FrameTimeStats frame = stats();
+    char line[160];
+    std::snprintf(line, sizeof(line), "Frames: %llu paced at %.0f fps, last %d mean %.2f ms p50 %.2f ms p99 %.2f ms max %.2f ms, %llu late, %.0f%% of waiting asleep\n",
+        static_cast<unsigned long long>(frames), framesPerSecond, frame.count, frame.mean, frame.p50, frame.p99, frame.max, frame.late, frame.sleptFraction * 100);
+    out << line;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Holds frames to a steady rate. Sleeping alone overshoots by however coarse the OS
+// scheduler is, and spinning alone burns a core, so wait() sleeps until shortly before
+// the frame is due and spins the rest. The spin margin adapts to how late the sleeps
+// actually wake up, so a machine with a precise scheduler spends almost no time spinning.
+// Headless like Profiler: main.cpp decides when to pace and when to idle instead.
+
+// Frame-to-frame intervals over the frames still held, in milliseconds
+struct FrameTimeStats {
+    int count;
+    double mean;
+    double p50;
+    double p99;
+    double max;
+    unsigned long long late;  // Frames that started more than a millisecond after they were due
+    double sleptFraction;     // Share of all waiting spent asleep rather than spinning
+};
+
+class FramePacer {
+public:
+    static const int CAPACITY = 1024;  // Intervals kept for the statistics
+
+    explicit FramePacer(float framesPerSecond = 0);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // 0 lets frames run as fast as they can; wait() then only records the intervals
+    void setRate(float framesPerSecond);
+
+    float rate() const {
+        return framesPerSecond;
+    }
+
+    // Blocks until the next frame is due and records the interval since the last one
+    void wait();
+
+    // Starts over from now, so a stretch without frames (an idle menu) is not counted as one long frame
+    void restart();
+
+    FrameTimeStats stats() const;
+    void printStats(std::ostream& out) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    float framesPerSecond;
+    Clock::duration period;
+    Clock::time_point deadline;      // When the next frame is due
+    Clock::time_point lastFrame;     // When wait() last returned
+    bool started;
+    Clock::duration spinMargin;      // How long before the deadline sleeping stops
+    std::vector<std::int64_t> intervals;  // Ring of frame intervals in nanoseconds
+    std::uint64_t frames;
+    unsigned long long late;
+    std::int64_t slept;              // Nanoseconds wait() spent asleep
+    std::int64_t spun;               // Nanoseconds wait() spent spinning
+    mutable std::vector<std::int64_t> scratch;  // Sorted copy of the intervals while summarizing
+};
@@ -0,0 +1,414 @@
+#include "GameWorld.h"
+
+GameWorld::GameWorld(std::uint64_t seed, const GameConfig& config) : config(config), bunny(375, 300), saucers(MAX_SAUCERS), logger(nullptr), profiler(nullptr), rng(seed) {
+    nearby.reserve(64);
+    reset();
+}
+
+void GameWorld::reset(std::uint64_t seed) {
+    rng.seed(seed);
+    reset();
+}
+
+void GameWorld::reset() {
+    bunny = Bunny(375, 300);
+    coins.clear();
+    saucers.clear();
+    powerUps.clear();
+    coinGrid.clear();
+    saucerGrid.clear();
+    stats.reset();
+
+    // Initial saucer positioning
+    addSaucer(200, 500);
+    addSaucer(500, 350);
+    addSaucer(300, 200);
+
+    minHeight = 600;
+    timers.clear(); // The spawn timers are armed on the first tick, once its length is known
+    lastPowerUp = SUPER_JUMP;
+    viewTop = 0;
+    previousViewTop = 0;
+    gameOver = false;
+
+    // Everything above the starting saucers comes from the level chunks
+    levelSeed = static_cast<std::uint64_t>(rng.saucers.next()) << 32;
+    levelSeed |= rng.saucers.next();
+    nextChunk = 0;
+    if (streamer.running()) {
+        streamer.restart(levelSeed, 0);
+    }
+    streamChunks();
+}
+
+void GameWorld::step(const InputState& input, float deltaTime) {
+    if (gameOver) {
+        return;
+    }
+
+    ProfileScope phase(profiler, PHASE_TIMERS);
+    storePreviousPositions();
+
+    if (timers.now() == 0) {
+        timers.schedule(TIMER_POWER_UP_SPAWN, ticksFor(config.powerUpSpawnInterval, deltaTime));
+        timers.schedule(TIMER_COIN_SPAWN, ticksFor(config.coinSpawnInterval, deltaTime));
+    }
+    timers.advance([&](int timer) {
+        onTimer(static_cast<TimerId>(timer), deltaTime);
+    });
+
+    if (currentHeight() <= 0.0f) {
+        gameOver = true;
+        return;
+    }
+
+    bool onSaucer = false;
+    // Minimum height calculation needs resetting every frame
+    float currentMinHeight = minHeight;
+
+    phase.switchTo(PHASE_COINS);
+    Rect bunnyBounds = bunny.bounds();
+    coinGrid.query(bunnyBounds.top, bunnyBounds.top + bunnyBounds.height, nearby);
+    for (int slot : nearby) {
+        if (coins[slot].checkCollision(bunnyBounds)) {
+            collectCoin(slot);
+        }
+    }
+
+    phase.switchTo(PHASE_SAUCERS);
+    saucers.update(deltaTime, WORLD_WIDTH);
+
+    // Power-ups ride on their saucer
+    powerUps.forEach([&](int, PowerUp& powerUp) {
+        int saucer = saucers.slot(powerUp.saucer);
+        powerUp.position = Vec2(saucers.x[saucer] + saucers.width[saucer] / 2 - 15, saucers.y[saucer] - 30);
+        powerUp.update(deltaTime); // Update rotation with deltaTime
+    });
+
+    // Saucers are visited in spawn order, as a plain loop over all of them would
+    saucerGrid.query(bunnyBounds.top, bunnyBounds.top + bunnyBounds.height, nearby);
+    for (std::size_t candidate = 0; candidate < nearby.size(); ++candidate) {
+        int serial = nearby[candidate];
+        int index = saucers.slot(serial);
+        bool isOnCurrentSaucer = (bunny.bounds().intersects(saucerBounds(serial)) || restsOn(serial)) && bunny.velocity.y >= 0;
+        if (isOnCurrentSaucer) {
+            bunny.velocity.y = 0;
+            bunny.position.y = saucers.y[index] - BUNNY_SIZE;
+
+            // The snap can lift the bunny onto saucers stacked above, so look again from
+            // its new position and carry on with the saucers after this one
+            saucerGrid.query(bunny.position.y, bunny.position.y + BUNNY_SIZE, nearby);
+            candidate = std::upper_bound(nearby.begin(), nearby.end(), serial) - nearby.begin() - 1;
+
+            if (!bunny.onSaucerLastFrame) {
+                stats.jumpedSaucer(); // Only call this when first landing on a saucer
+            }
+            onSaucer = true;
+
+            currentMinHeight = std::min(currentMinHeight, saucers.y[index]);
+        }
+        if (saucers.powerUp[index] >= 0) {
+            PowerUp& powerUp = powerUps[saucers.powerUp[index]];
+            if (powerUp.isActive && powerUp.bounds().intersects(bunny.bounds())) {
+                collectPowerUp(powerUp, deltaTime);
+            }
+        }
+    }
+    // After all saucers have been processed, update the onSaucerLastFrame
+    bunny.onSaucerLastFrame = onSaucer;
+
+    phase.switchTo(PHASE_BUNNY);
+    Vec2 from = bunny.position;
+    bunny.update(config, onSaucer, input, deltaTime);
+    sweepBunny(from, deltaTime);
+    phase.switchTo(PHASE_STREAMING);
+
+    minHeight = std::min(minHeight, currentMinHeight);
+
+    // Follow the bunny if it moves up
+    if (bunny.position.y < 300) {
+        viewTop = bunny.position.y - 300;
+    }
+
+    // Keep the level ahead of the camera and drop what it has passed
+    streamChunks();
+    retirePassedChunks();
+}
+
+void GameWorld::onTimer(TimerId timer, float deltaTime) {
+    switch (timer) {
+    case TIMER_POWER_UP_SPAWN: {
+        // Find the highest saucer on screen that doesn't have a power-up
+        int highestSaucer = -1;
+        for (int serial = saucers.head; serial != saucers.tail; ++serial) {
+            int i = saucers.slot(serial);
+            if (saucers.powerUp[i] < 0 && saucers.y[i] >= viewTop && (highestSaucer < 0 || saucers.y[i] < saucers.y[saucers.slot(highestSaucer)])) {
+                highestSaucer = serial;
+            }
+        }
+        if (highestSaucer >= 0) {
+            spawnPowerUpOnSaucer(highestSaucer);
+            timers.schedule(TIMER_POWER_UP_SPAWN, ticksFor(config.powerUpSpawnInterval, deltaTime));
+        }
+        else {
+            timers.schedule(TIMER_POWER_UP_SPAWN, 1); // Every saucer in view has one: try again next tick
+        }
+        break;
+    }
+    case TIMER_COIN_SPAWN: {
+        float newX = rng.coins.uniform(0, WORLD_WIDTH - 30); // Adjust to prevent spawn outside the view
+        float newY = bunny.position.y - 200; // Coins spawn above the bunny
+        addCoin(newX, newY);
+        timers.schedule(TIMER_COIN_SPAWN, ticksFor(config.coinSpawnInterval, deltaTime));
+        break;
+    }
+    case TIMER_SUPER_JUMP:
+        bunny.superJumpActive = false;
+        break;
+    case TIMER_SPEED_BOOST:
+        bunny.speedBoostActive = false;
+        bunny.velocity.x /= 0.5; // Reset speed back to normal when boost ends
+        break;
+    case TIMER_MAGNET:
+        bunny.magnetActive = false;
+        break;
+    case TIMER_POWER_UP_MESSAGE:
+    case TIMER_COUNT:
+        break;
+    }
+}
+
+void GameWorld::collectCoin(int slot) {
+    stats.score += 200; // Add points for collecting a coin
+    coinGrid.remove(slot, coins[slot].position.y);
+    coins.release(slot); // Coin collected
+}
+
+void GameWorld::collectPowerUp(PowerUp& powerUp, float deltaTime) {
+    powerUp.activate(bunny);
+    lastPowerUp = powerUp.type;
+    TimerId effect = powerUp.type == SUPER_JUMP ? TIMER_SUPER_JUMP : powerUp.type == SPEED_BOOST ? TIMER_SPEED_BOOST : TIMER_MAGNET;
+    timers.schedule(effect, ticksFor(config.powerUpDuration, deltaTime));
+    timers.schedule(TIMER_POWER_UP_MESSAGE, ticksFor(2.0f, deltaTime)); // Display message for 2 seconds
+    if (logger) {
+        logger->write(LOG_INFO, "Activated %s", powerUpName(powerUp.type));
+    }
+}
+
+// The overlap checks at the start of a tick only see where the last move ended. When a
+// long tick or a fast fall carries the bunny clean through a saucer (20 px tall) or a
+// pickup, the move is swept instead: the bunny stops on the first saucer top its feet
+// crossed, and lands there on the next tick, and whatever it passed through on the way
+// there is collected. Anything it still overlaps at the end of the move is left to those
+// checks, as it always was.
+void GameWorld::sweepBunny(const Vec2& from, float deltaTime) {
+    Vec2 delta(bunny.position.x - from.x, bunny.position.y - from.y);
+    Rect start(from.x, from.y, BUNNY_SIZE, BUNNY_SIZE);
+    float top = std::min(from.y, bunny.position.y);
+    float bottom = std::max(from.y, bunny.position.y) + BUNNY_SIZE;
+
+    // Saucers are only landed on from above, when the feet cross the saucer's top
+    float reach = 1; // Fraction of the move the bunny gets through
+    int landing = -1;
+    saucerGrid.query(top, bottom, nearby);
+    if (delta.y > 0) {
+        float feet = from.y + BUNNY_SIZE;
+        for (int serial : nearby) {
+            Rect saucer = saucerBounds(serial);
+            if (feet > saucer.top) {
+                continue;
+            }
+            float t = (saucer.top - feet) / delta.y;
+            float x = from.x + delta.x * t;
+            if (t < reach && x < saucer.left + saucer.width && x + BUNNY_SIZE > saucer.left) {
+                reach = t;
+                landing = serial;
+            }
+        }
+    }
+    if (landing >= 0 && !bunny.bounds().intersects(saucerBounds(landing))) {
+        bunny.position = Vec2(from.x + delta.x * reach, saucers.y[saucers.slot(landing)] - BUNNY_SIZE);
+    }
+    else {
+        reach = 1;
+    }
+
+    Rect end = bunny.bounds();
+    for (int serial : nearby) {
+        int powerUpSlot = saucers.powerUp[saucers.slot(serial)];
+        if (powerUpSlot >= 0 && powerUps[powerUpSlot].isActive) {
+            Rect bounds = powerUps[powerUpSlot].bounds();
+            float t = timeOfImpact(start, delta, bounds);
+            if (t >= 0 && t <= reach && !end.intersects(bounds)) {
+                collectPowerUp(powerUps[powerUpSlot], deltaTime);
+            }
+        }
+    }
+
+    coinGrid.query(top, bottom, nearby);
+    for (int slot : nearby) {
+        Rect bounds = coins[slot].bounds();
+        float t = timeOfImpact(start, delta, bounds);
+        if (t >= 0 && t <= reach && !end.intersects(bounds)) {
+            collectCoin(slot);
+        }
+    }
+}
+
+void GameWorld::storePreviousPositions() {
+    bunny.previousPosition = bunny.position;
+    saucers.storePreviousPositions();
+    powerUps.forEach([](int, PowerUp& powerUp) {
+        powerUp.previousPosition = powerUp.position;
+    });
+    previousViewTop = viewTop;
+}
+
+void GameWorld::save(WorldSnapshot& snapshot) const {
+    snapshot.config = config;
+    snapshot.bunny = bunny;
+    snapshot.coins = coins;
+    snapshot.powerUps = powerUps;
+    snapshot.stats = stats;
+    snapshot.rng = rng;
+    snapshot.timers = timers;
+
+    snapshot.saucerHead = saucers.head;
+    snapshot.saucerTail = saucers.tail;
+    std::copy(saucers.x.begin(), saucers.x.end(), snapshot.saucerX);
+    std::copy(saucers.y.begin(), saucers.y.end(), snapshot.saucerY);
+    std::copy(saucers.width.begin(), saucers.width.end(), snapshot.saucerWidth);
+    std::copy(saucers.height.begin(), saucers.height.end(), snapshot.saucerHeight);
+    std::copy(saucers.speed.begin(), saucers.speed.end(), snapshot.saucerSpeed);
+    std::copy(saucers.direction.begin(), saucers.direction.end(), snapshot.saucerDirection);
+    std::copy(saucers.previousX.begin(), saucers.previousX.end(), snapshot.saucerPreviousX);
+    std::copy(saucers.powerUp.begin(), saucers.powerUp.end(), snapshot.saucerPowerUp);
+
+    snapshot.minHeight = minHeight;
+    snapshot.levelSeed = levelSeed;
+    snapshot.nextChunk = nextChunk;
+    snapshot.lastPowerUp = lastPowerUp;
+    snapshot.viewTop = viewTop;
+    snapshot.previousViewTop = previousViewTop;
+    snapshot.gameOver = gameOver;
+}
+
+void GameWorld::restore(const WorldSnapshot& snapshot) {
+    config = snapshot.config;
+    bunny = snapshot.bunny;
+    coins = snapshot.coins;
+    powerUps = snapshot.powerUps;
+    stats = snapshot.stats;
+    rng = snapshot.rng;
+    timers = snapshot.timers;
+
+    saucers.head = snapshot.saucerHead;
+    saucers.tail = snapshot.saucerTail;
+    std::copy(snapshot.saucerX, snapshot.saucerX + MAX_SAUCERS, saucers.x.begin());
+    std::copy(snapshot.saucerY, snapshot.saucerY + MAX_SAUCERS, saucers.y.begin());
+    std::copy(snapshot.saucerWidth, snapshot.saucerWidth + MAX_SAUCERS, saucers.width.begin());
+    std::copy(snapshot.saucerHeight, snapshot.saucerHeight + MAX_SAUCERS, saucers.height.begin());
+    std::copy(snapshot.saucerSpeed, snapshot.saucerSpeed + MAX_SAUCERS, saucers.speed.begin());
+    std::copy(snapshot.saucerDirection, snapshot.saucerDirection + MAX_SAUCERS, saucers.direction.begin());
+    std::copy(snapshot.saucerPreviousX, snapshot.saucerPreviousX + MAX_SAUCERS, saucers.previousX.begin());
+    std::copy(snapshot.saucerPowerUp, snapshot.saucerPowerUp + MAX_SAUCERS, saucers.powerUp.begin());
+
+    minHeight = snapshot.minHeight;
+    levelSeed = snapshot.levelSeed;
+    nextChunk = snapshot.nextChunk;
+    lastPowerUp = snapshot.lastPowerUp;
+    viewTop = snapshot.viewTop;
+    previousViewTop = snapshot.previousViewTop;
+    gameOver = snapshot.gameOver;
+
+    // Grid query results come back sorted, so rebuilt grids answer exactly as before
+    coinGrid.clear();
+    coins.forEach([&](int slot, const Coin& coin) {
+        coinGrid.insert(slot, coin.position.y, Coin::RADIUS * 2);
+    });
+    saucerGrid.clear();
+    for (int serial = saucers.head; serial != saucers.tail; ++serial) {
+        saucerGrid.insert(serial, saucers.y[saucers.slot(serial)] - POWER_UP_REACH, POWER_UP_REACH + 20);
+    }
+}
+
+void GameWorld::addCoin(float x, float y) {
+    int slot = coins.acquire();
+    if (slot < 0) {
+        // Pool exhausted: recycle the coin furthest below, which the bunny has long passed
+        coins.forEach([&](int candidate, const Coin& coin) {
+            if (slot < 0 || coin.position.y > coins[slot].position.y) {
+                slot = candidate;
+            }
+        });
+        coinGrid.remove(slot, coins[slot].position.y);
+    }
+    coins[slot] = Coin(x, y);
+    coinGrid.insert(slot, y, Coin::RADIUS * 2);
+}
+
+void GameWorld::addSaucer(float x, float y) {
+    if (saucers.full()) {
+        removeOldestSaucer();
+    }
+    int serial = saucers.add(x, y, 100, 20);
+    saucerGrid.insert(serial, y - POWER_UP_REACH, POWER_UP_REACH + 20);
+}
+
+void GameWorld::removeOldestSaucer() {
+    int serial = saucers.head;
+    int slot = saucers.slot(serial);
+    if (saucers.powerUp[slot] >= 0) {
+        powerUps.release(saucers.powerUp[slot]);
+    }
+    saucerGrid.remove(serial, saucers.y[slot] - POWER_UP_REACH);
+    saucers.popFront();
+}
+
+void GameWorld::streamChunks() {
+    LevelChunk chunk;
+    while (chunkBase(nextChunk) > viewTop - STREAM_AHEAD_CHUNKS * CHUNK_HEIGHT) {
+        streamer.take(levelSeed, nextChunk, chunk);
+        for (int i = 0; i < SAUCERS_PER_CHUNK; ++i) {
+            addSaucer(chunk.saucerX[i], chunk.saucerY[i]);
+        }
+        nextChunk++;
+    }
+}
+
+void GameWorld::retirePassedChunks() {
+    // Saucers sit in the ring in chunk order, so a passed chunk is a run at the front
+    while (saucers.size() > 0) {
+        int chunk = chunkOf(saucers.y[saucers.slot(saucers.head)]);
+        if (chunkBase(chunk) - CHUNK_HEIGHT < viewTop + WORLD_HEIGHT + RETIRE_MARGIN) {
+            break;
+        }
+        while (saucers.size() > 0 && chunkOf(saucers.y[saucers.slot(saucers.head)]) == chunk) {
+            removeOldestSaucer();
+        }
+    }
+
+    // Coins the bunny climbed past without collecting can never be reached again
+    float retireLine = viewTop + WORLD_HEIGHT + RETIRE_MARGIN;
+    coins.forEach([&](int slot, const Coin& coin) {
+        if (coin.position.y > retireLine) {
+            coinGrid.remove(slot, coin.position.y);
+            coins.release(slot);
+        }
+    });
+}
+
+void GameWorld::spawnPowerUpOnSaucer(int serial) {
+    int saucer = saucers.slot(serial);
+    if (saucers.powerUp[saucer] < 0) { // Only spawn a power-up if there isn't already one
+        int slot = powerUps.acquire();
+        if (slot < 0) {
+            return;
+        }
+        PowerUpType randomType = static_cast<PowerUpType>(rng.powerUps.range(0, 2)); // Random type from 0 to 2
+        float x = saucers.x[saucer] + saucers.width[saucer] / 2 - 15; // Centered on the saucer
+        float y = saucers.y[saucer] - 30; // Above the saucer
+        powerUps[slot] = PowerUp(randomType, x, y, serial);
+        saucers.powerUp[saucer] = slot;
+    }
+}
@@ -0,0 +1,407 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include "SpatialGrid.h"
+#include "SaucerField.h"
+#include "LevelStreamer.h"
+#include "Pool.h"
+#include "TimerWheel.h"
+#include "Rng.h"
+#include "Profiler.h"
+#include "Logger.h"
+
+// Headless game simulation. Nothing in here touches SFML, so the world can be
+// stepped without a window (batch runner, CI) and drawn by main.cpp when there is one.
+
+const float WORLD_WIDTH = 800.f;
+const float WORLD_HEIGHT = 600.f;
+const float BUNNY_SIZE = 1024 * 0.1f; // bunny.png is 1024x1024 drawn at 0.1 scale
+const float SIM_TICK_RATE = 60.f;     // Default simulation ticks per second
+const float POWER_UP_REACH = 60.f;    // How far above its saucer a power-up can extend
+
+// Entity budgets. All storage is allocated once, so steady gameplay never hits the heap.
+const int MAX_COINS = 64;
+const int MAX_SAUCERS = 128;     // Ring buffer; the lowest saucer makes way for a new one
+const int MAX_POWER_UPS = MAX_SAUCERS;
+
+// Level chunks kept in the world above the top of the view, and how far below the bottom
+// of the view a chunk has to be before its saucers are retired (coins go at the same line)
+const int STREAM_AHEAD_CHUNKS = 3;
+const float RETIRE_MARGIN = WORLD_HEIGHT;
+
+// Tuning knobs for the physics and spawning. The defaults are the game as shipped;
+// the sweep tool runs the bot over grids of other values.
+struct GameConfig {
+    float gravity;               // Pixels per second squared
+    float jumpVelocity;          // Upward speed of a normal jump
+    float superJumpVelocity;     // Upward speed of a jump with Super Jump active
+    float baseSpeed;             // Horizontal speed, doubled by Speed Boost
+    float powerUpDuration;       // Seconds a collected power-up lasts
+    float coinSpawnInterval;     // Seconds between coins
+    float powerUpSpawnInterval;  // Seconds between power-ups
+
+    GameConfig() : gravity(980), jumpVelocity(600), superJumpVelocity(900), baseSpeed(300),
+        powerUpDuration(5), coinSpawnInterval(10), powerUpSpawnInterval(5) {}
+};
+
+enum GameState {
+    MAIN_MENU,
+    GAME_PLAY,
+    GAME_OVER
+};
+
+enum PowerUpType {
+    SUPER_JUMP,
+    SPEED_BOOST,
+    MAGNET
+};
+
+// Everything in a run that happens after a delay, one timer each on GameWorld::timers
+enum TimerId {
+    TIMER_POWER_UP_SPAWN,    // Next power-up appears on a saucer
+    TIMER_COIN_SPAWN,        // Next coin appears above the bunny
+    TIMER_SUPER_JUMP,        // Super Jump wears off
+    TIMER_SPEED_BOOST,       // Speed Boost wears off
+    TIMER_MAGNET,            // Magnet wears off
+    TIMER_POWER_UP_MESSAGE,  // "Activated!" message goes away
+    TIMER_COUNT
+};
+
+// Simulation ticks of tickDuration seconds that make up seconds, at least one
+inline std::uint32_t ticksFor(float seconds, float tickDuration) {
+    long ticks = std::lround(seconds / tickDuration);
+    return ticks > 1 ? static_cast<std::uint32_t>(ticks) : 1;
+}
+
+inline const char* powerUpName(PowerUpType type) {
+    switch (type) {
+    case SUPER_JUMP: return "Super Jump";
+    case SPEED_BOOST: return "Speed Boost";
+    case MAGNET: return "Magnet";
+    }
+    return "";
+}
+
+struct Vec2 {
+    float x;
+    float y;
+
+    Vec2() : x(0), y(0) {}
+    Vec2(float x, float y) : x(x), y(y) {}
+};
+
+inline Vec2 lerp(const Vec2& from, const Vec2& to, float t) {
+    return Vec2(from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t);
+}
+
+// Axis-aligned box with the same semantics as sf::FloatRect (edges touching do not intersect)
+struct Rect {
+    float left;
+    float top;
+    float width;
+    float height;
+
+    Rect() : left(0), top(0), width(0), height(0) {}
+    Rect(float left, float top, float width, float height) : left(left), top(top), width(width), height(height) {}
+
+    bool intersects(const Rect& other) const {
+        float interLeft = std::max(left, other.left);
+        float interTop = std::max(top, other.top);
+        float interRight = std::min(left + width, other.left + other.width);
+        float interBottom = std::min(top + height, other.top + other.height);
+        return interLeft < interRight && interTop < interBottom;
+    }
+};
+
+// Narrows [enter, exit) to the part of a move along one axis where a span starting at
+// start overlaps the target span. False once nothing of the move is left.
+inline bool sweepAxis(float start, float size, float delta, float targetStart, float targetSize, float& enter, float& exit) {
+    float low = targetStart - size;  // The spans overlap while start is strictly between these
+    float high = targetStart + targetSize;
+    if (delta == 0) {
+        return start > low && start < high;
+    }
+    float first = (low - start) / delta;
+    float last = (high - start) / delta;
+    if (first > last) {
+        std::swap(first, last);
+    }
+    enter = std::max(enter, first);
+    exit = std::min(exit, last);
+    return enter < exit;
+}
+
+// Fraction of delta at which moving, translated by delta, first overlaps target: 0 if the
+// two already overlap, -1 if they never do during the move
+inline float timeOfImpact(const Rect& moving, const Vec2& delta, const Rect& target) {
+    float enter = 0;
+    float exit = 1;
+    if (!sweepAxis(moving.left, moving.width, delta.x, target.left, target.width, enter, exit)
+        || !sweepAxis(moving.top, moving.height, delta.y, target.top, target.height, enter, exit)) {
+        return -1;
+    }
+    return enter;
+}
+
+// One frame worth of player input, filled from the keyboard or from a bot/replay
+struct InputState {
+    bool jump;
+    bool left;
+    bool right;
+
+    InputState() : jump(false), left(false), right(false) {}
+};
+
+class GameStats {
+public:
+    int score;           // Current score
+    int highScore;       // High score during the session
+    int saucersJumped;   // Count of saucers the bunny has jumped on
+
+    GameStats() : score(0), highScore(0), saucersJumped(0) {}
+
+    void addScore(int points) {
+        score += points;
+        if (score > highScore) {
+            highScore = score;  // Update high score if current score is greater
+        }
+    }
+
+    void jumpedSaucer() {
+        saucersJumped++;
+        addScore(10);  // Adds 10 points for every saucer jumped
+    }
+
+    void reset() {
+        score = 0;
+        saucersJumped = 0;
+    }
+};
+
+class Bunny {
+public:
+    Vec2 position;
+    Vec2 previousPosition;  // Position at the start of the last tick, for render interpolation
+    Vec2 velocity;
+    bool superJumpActive;   // Power-up effects; GameWorld's timers switch them off again
+    bool speedBoostActive;
+    bool magnetActive;
+    bool onSaucerLastFrame;
+
+    Bunny(float x, float y) : position(x, y), previousPosition(x, y), superJumpActive(false),
+        speedBoostActive(false), magnetActive(false), onSaucerLastFrame(false) {
+    }
+
+    Rect bounds() const {
+        return Rect(position.x, position.y, BUNNY_SIZE, BUNNY_SIZE);
+    }
+
+    void update(const GameConfig& config, bool onSaucer, const InputState& input, float deltaTime) {
+        velocity.y += config.gravity * deltaTime; // Apply gravity to vertical velocity
+
+        if (onSaucer && input.jump) {
+            jump(config);
+        }
+
+        // Adjust horizontal velocity based on current state of speed boost and input
+        float currentSpeed = speedBoostActive ? config.baseSpeed * 2.0f : config.baseSpeed; // Apply boost
+
+        if (input.left) {
+            velocity.x = -currentSpeed;
+        }
+        else if (input.right) {
+            velocity.x = currentSpeed;
+        }
+        else {
+            velocity.x = 0; // No horizontal input means no horizontal movement
+        }
+
+        // Apply the calculated velocity to update position
+        position.x += velocity.x * deltaTime;
+        position.y += velocity.y * deltaTime;
+    }
+
+    void jump(const GameConfig& config) {
+        if (superJumpActive) {
+            velocity.y = -config.superJumpVelocity; // Increased jump height for super jump
+        }
+        else {
+            velocity.y = -config.jumpVelocity; // Normal jump height
+        }
+    }
+};
+
+class PowerUp {
+public:
+    Vec2 position;   // Centre of the power-up (the shape origin)
+    Vec2 previousPosition;
+    float rotation;  // Degrees
+    PowerUpType type;
+    bool isActive;
+    int saucer;      // Serial of the saucer it rides on
+
+    PowerUp(PowerUpType type = SUPER_JUMP, float x = 0, float y = 0, int saucer = -1) : position(x, y), previousPosition(x, y), rotation(0), type(type), isActive(true), saucer(saucer) {}
+
+    void update(float deltaTime) {
+        rotation = std::fmod(rotation + 90 * deltaTime, 360.f); // Rotating effect, 90 degrees per second
+    }
+
+    // Bounding box of the rotated 30x30 square, as sf::Shape::getGlobalBounds reports it
+    Rect bounds() const {
+        const float radians = rotation * 3.14159265f / 180.f;
+        float halfExtent = 15 * (std::fabs(std::cos(radians)) + std::fabs(std::sin(radians)));
+        return Rect(position.x - halfExtent, position.y - halfExtent, halfExtent * 2, halfExtent * 2);
+    }
+
+    // Switches the effect on; the world schedules when it wears off
+    void activate(Bunny& bunny) {
+        isActive = false; // Mark as consumed
+        switch (type) {
+        case SUPER_JUMP:
+            bunny.superJumpActive = true;
+            break;
+        case SPEED_BOOST:
+            bunny.speedBoostActive = true;
+            bunny.velocity.x *= 10.5;
+            break;
+        case MAGNET:
+            bunny.magnetActive = true;
+            // Implement magnet logic if applicable
+            break;
+        }
+    }
+};
+
+class Coin {
+public:
+    Vec2 position;  // Top-left of the coin's bounding box
+
+    static constexpr float RADIUS = 15;
+
+    Coin(float x = 0, float y = 0) : position(x, y) {}
+
+    Rect bounds() const {
+        return Rect(position.x, position.y, RADIUS * 2, RADIUS * 2);
+    }
+
+    bool checkCollision(const Rect& bunnyBounds) const {
+        return bounds().intersects(bunnyBounds);
+    }
+};
+
+// Complete state of a GameWorld in plain fixed-size arrays, so taking or restoring one is
+// a single memcpy-sized copy (about 12 KB). The spatial grids are not stored: restore
+// rebuilds them from the entities, which is cheaper than copying their buckets.
+struct WorldSnapshot {
+    GameConfig config;
+    Bunny bunny;
+    Pool<Coin, MAX_COINS> coins;
+    Pool<PowerUp, MAX_POWER_UPS> powerUps;
+    GameStats stats;
+    Rng rng;
+    TimerWheel<TIMER_COUNT> timers;
+
+    // Saucer ring, slot for slot
+    int saucerHead;
+    int saucerTail;
+    float saucerX[MAX_SAUCERS];
+    float saucerY[MAX_SAUCERS];
+    float saucerWidth[MAX_SAUCERS];
+    float saucerHeight[MAX_SAUCERS];
+    float saucerSpeed[MAX_SAUCERS];
+    float saucerDirection[MAX_SAUCERS];
+    float saucerPreviousX[MAX_SAUCERS];
+    int saucerPowerUp[MAX_SAUCERS];
+
+    float minHeight;
+    std::uint64_t levelSeed;
+    int nextChunk;
+    PowerUpType lastPowerUp;
+    float viewTop;
+    float previousViewTop;
+    bool gameOver;
+
+    WorldSnapshot() : bunny(0, 0) {}
+};
+
+static_assert(std::is_trivially_copyable<WorldSnapshot>::value, "WorldSnapshot must stay a plain copy");
+
+// Everything that makes up one run of the game. step() advances it by one fixed
+// tick from an InputState; rendering reads the public members and interpolates
+// between previousPosition and position.
+class GameWorld {
+public:
+    GameConfig config;
+    Bunny bunny;
+    Pool<Coin, MAX_COINS> coins;
+    SaucerField saucers;
+    Pool<PowerUp, MAX_POWER_UPS> powerUps;
+    GameStats stats;
+
+    float minHeight;          // Track the minimum height (highest point) the bunny has reached
+    std::uint64_t levelSeed;  // Saucer layout of this run, drawn from the saucer stream on reset
+    int nextChunk;            // Index of the next level chunk to add
+    PowerUpType lastPowerUp;  // Type of the most recently collected power-up
+    float viewTop;            // Top edge of the camera in world coordinates
+    float previousViewTop;
+    bool gameOver;
+    Logger* logger;           // Logs pickups when set (the windowed game sets it)
+    Profiler* profiler;       // Times the phases of step() when set
+
+    Rng rng;                  // Every random draw the level makes comes from here
+    TimerWheel<TIMER_COUNT> timers;  // Spawns and power-up effects, counted in ticks of the run
+    LevelStreamer streamer;   // Generates level chunks, on a worker thread once started
+
+    // Broadphase over coins (by pool slot) and saucers (by serial; a saucer's band
+    // includes its power-up). Entries are added and removed along with the entities.
+    SpatialGrid coinGrid;
+    SpatialGrid saucerGrid;
+    std::vector<int> nearby;  // Scratch list of query results
+
+    explicit GameWorld(std::uint64_t seed = std::random_device()(), const GameConfig& config = GameConfig());
+
+    void reset();                    // New run continuing the current random streams
+    void reset(std::uint64_t seed);  // New run that replays exactly for the same seed and inputs
+    void step(const InputState& input, float deltaTime);
+    void storePreviousPositions();
+
+    // Copies the whole simulation state out, or back in. A restored world steps exactly
+    // as the saved one would have, so a bot can try several futures from one moment.
+    void save(WorldSnapshot& snapshot) const;
+    void restore(const WorldSnapshot& snapshot);
+    void addCoin(float x, float y);
+    void addSaucer(float x, float y);
+    void removeOldestSaucer();
+    void streamChunks();        // Adds chunks until STREAM_AHEAD_CHUNKS are ready above the view
+    void retirePassedChunks();  // Drops whole chunks and any coins the camera has left behind
+    void spawnPowerUpOnSaucer(int serial);
+    void onTimer(TimerId timer, float deltaTime);
+    void collectCoin(int slot);
+    void collectPowerUp(PowerUp& powerUp, float deltaTime);
+    void sweepBunny(const Vec2& from, float deltaTime);
+
+    bool showingPowerUpMessage() const {
+        return timers.pending(TIMER_POWER_UP_MESSAGE);
+    }
+
+    Rect saucerBounds(int serial) const {
+        int i = saucers.slot(serial);
+        return Rect(saucers.x[i], saucers.y[i], saucers.width[i], saucers.height[i]);
+    }
+
+    // Whether the bunny was stopped exactly on top of the saucer by sweepBunny
+    bool restsOn(int serial) const {
+        int i = saucers.slot(serial);
+        return bunny.position.y == saucers.y[i] - BUNNY_SIZE
+            && bunny.position.x < saucers.x[i] + saucers.width[i] && bunny.position.x + BUNNY_SIZE > saucers.x[i];
+    }
+
+    // Height above the bottom of the starting screen, as shown in the HUD
+    float currentHeight() const {
+        return WORLD_HEIGHT - bunny.position.y;
+    }
+};
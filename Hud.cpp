@@ -0,0 +1,62 @@
+#include "Hud.h"
+#include <climits>
+#include <cstdio>
+
+Hud::Hud(const sf::Font& font)
+    : rebuilds(0), shownScore(INT_MIN), shownHighScore(INT_MIN), shownHeight(INT_MIN), shownPowerUp(-1), powerUpWidth(0) {
+    sf::Text* texts[] = { &scoreText, &highScoreText, &heightText, &powerUpMessage };
+    for (sf::Text* text : texts) {
+        text->setFont(font);
+        text->setCharacterSize(24);
+        text->setFillColor(sf::Color::Black);
+    }
+    powerUpMessage.setFillColor(sf::Color::White);
+}
+
+void Hud::setText(sf::Text& text, const char* format, int value) {
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    text.setString(buffer);
+    rebuilds++;
+}
+
+void Hud::update(const GameWorld& world) {
+    if (world.stats.score != shownScore) {
+        shownScore = world.stats.score;
+        setText(scoreText, "Score: %d", shownScore);
+    }
+    if (world.stats.highScore != shownHighScore) {
+        shownHighScore = world.stats.highScore;
+        setText(highScoreText, "High Score: %d", shownHighScore);
+    }
+    int height = static_cast<int>(world.currentHeight());
+    if (height != shownHeight) {
+        shownHeight = height;
+        setText(heightText, "Height: %d units", shownHeight);
+    }
+
+    int powerUp = world.showingPowerUpMessage() ? world.lastPowerUp : -1;
+    if (powerUp != shownPowerUp) {
+        shownPowerUp = powerUp;
+        if (powerUp >= 0) {
+            std::snprintf(buffer, sizeof(buffer), "%s Activated!", powerUpName(world.lastPowerUp));
+            powerUpMessage.setString(buffer);
+            powerUpWidth = powerUpMessage.getLocalBounds().width;
+            rebuilds++;
+        }
+    }
+}
+
+void Hud::draw(sf::RenderTarget& target, bool showPowerUpMessage) {
+    sf::Vector2f center = target.getView().getCenter();
+    scoreText.setPosition(center.x - 390, center.y - 290);
+    highScoreText.setPosition(center.x + 150, center.y - 290);
+    heightText.setPosition(center.x - 390, center.y - 250);
+    target.draw(scoreText);
+    target.draw(highScoreText);
+    target.draw(heightText);
+
+    if (showPowerUpMessage && shownPowerUp >= 0) {
+        powerUpMessage.setPosition(center.x - powerUpWidth / 2, center.y - 300); // Centered at the top of the screen
+        target.draw(powerUpMessage);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "GameWorld.h"
+
+// Score, high score, height and power-up message. sf::Text rebuilds its glyph geometry
+// on every setString, so each text is only re-formatted when the value it shows has
+// changed; between changes drawing just moves the cached geometry along with the view.
+class Hud {
+public:
+    unsigned int rebuilds;  // setString calls so far
+
+    explicit Hud(const sf::Font& font);
+
+    // Re-formats whichever texts no longer match the world
+    void update(const GameWorld& world);
+
+    // Draws the HUD anchored to the target's current view. The power-up message only
+    // shows during gameplay.
+    void draw(sf::RenderTarget& target, bool showPowerUpMessage);
+
+private:
+    sf::Text scoreText;
+    sf::Text highScoreText;
+    sf::Text heightText;
+    sf::Text powerUpMessage;
+
+    // Values the texts currently show
+    int shownScore;
+    int shownHighScore;
+    int shownHeight;
+    int shownPowerUp;      // PowerUpType of the message, or -1 while none is active
+    float powerUpWidth;    // Width of the message, measured once when it changes
+
+    char buffer[64];       // Formatting scratch, so numbers never go through std::string
+
+    void setText(sf::Text& text, const char* format, int value);
+};
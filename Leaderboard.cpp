@@ -0,0 +1,299 @@
+#include "Leaderboard.h"
+#include "GameWorld.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+// Both files are native little-endian structs, which every platform the game ships on is.
+//   .log: "BJLG", u32 version, u64 reserved, then one RunRecord per run, oldest first
+//   .idx: "BJLX", u32 version, u32 table size, u32 reserved, then two LeaderboardTables
+static const char LOG_MAGIC[4] = { 'B', 'J', 'L', 'G' };
+static const char INDEX_MAGIC[4] = { 'B', 'J', 'L', 'X' };
+static const std::uint32_t LEADERBOARD_VERSION = 1;
+
+struct LogHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t reserved;
+};
+
+struct IndexFile {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t size;
+    std::uint32_t reserved;
+    LeaderboardTable tables[2];
+};
+
+static std::uint32_t checksum(const void* data, std::size_t size, std::uint32_t hash = 2166136261u) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u; // FNV-1a
+    }
+    return hash;
+}
+
+static std::uint32_t recordChecksum(const RunRecord& run) {
+    return checksum(&run, offsetof(RunRecord, check));
+}
+
+static std::uint32_t tableChecksum(const LeaderboardTable& table) {
+    std::uint32_t hash = checksum(&table, offsetof(LeaderboardTable, check));
+    const std::size_t rest = offsetof(LeaderboardTable, entries);
+    return checksum(reinterpret_cast<const char*>(&table) + rest, sizeof(LeaderboardTable) - rest, hash);
+}
+
+static bool validTable(const LeaderboardTable& table) {
+    return table.sequence > 0 && table.count >= 0 && table.count <= LEADERBOARD_SIZE && table.check == tableChecksum(table);
+}
+
+RunRecord finishedRun(const GameWorld& world, std::uint64_t seed) {
+    RunRecord run;
+    std::memset(&run, 0, sizeof(run));
+    run.seed = seed;
+    run.time = static_cast<std::int64_t>(std::time(nullptr));
+    run.score = world.stats.score;
+    run.saucersJumped = world.stats.saucersJumped;
+    run.height = WORLD_HEIGHT - world.minHeight;
+    return run;
+}
+
+Leaderboard::Leaderboard() : changes(0), stopping(false) {
+    std::memset(&table, 0, sizeof(table));
+}
+
+Leaderboard::~Leaderboard() {
+    close();
+}
+
+bool Leaderboard::open(const std::string& basePath) {
+    close();
+
+    const std::string logPath = basePath + ".log";
+    if (!log.open(logPath)) {
+        std::cerr << "Failed to open leaderboard " << logPath << std::endl;
+        return false;
+    }
+    LogHeader header;
+    if (log.size() == 0) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+        header.version = LEADERBOARD_VERSION;
+        log.append(&header, sizeof(header));
+    }
+    if (!log.read(0, &header, sizeof(header)) || std::memcmp(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0
+        || header.version != LEADERBOARD_VERSION) {
+        std::cerr << logPath << " is not a version " << LEADERBOARD_VERSION << " leaderboard" << std::endl;
+        log.close();
+        return false;
+    }
+
+    // A crash can only tear the last append: drop a partial record, or a whole one whose checksum fails
+    std::uint64_t logRuns = (log.size() - sizeof(LogHeader)) / sizeof(RunRecord);
+    RunRecord last;
+    if (logRuns > 0 && (!log.read(sizeof(LogHeader) + (logRuns - 1) * sizeof(RunRecord), &last, sizeof(last)) || last.check != recordChecksum(last))) {
+        logRuns--;
+    }
+    if (log.size() != sizeof(LogHeader) + logRuns * sizeof(RunRecord)) {
+        std::cerr << "Dropping a run torn by a crash from " << logPath << std::endl;
+        log.truncate(sizeof(LogHeader) + logRuns * sizeof(RunRecord));
+    }
+
+    const std::string indexPath = basePath + ".idx";
+    if (!index.openWrite(indexPath, sizeof(IndexFile)) || index.size() < sizeof(IndexFile)) {
+        std::cerr << "Failed to map leaderboard index " << indexPath << std::endl;
+        close();
+        return false;
+    }
+    IndexFile& file = *reinterpret_cast<IndexFile*>(index.data());
+    if (std::memcmp(file.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || file.version != LEADERBOARD_VERSION || file.size != LEADERBOARD_SIZE) {
+        // New, or from another build: start over from the log
+        std::memset(&file, 0, sizeof(file));
+        std::memcpy(file.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        file.version = LEADERBOARD_VERSION;
+        file.size = LEADERBOARD_SIZE;
+    }
+
+    // The newer of the two copies that survived intact
+    const LeaderboardTable* newest = nullptr;
+    for (const LeaderboardTable& copy : file.tables) {
+        if (validTable(copy) && (!newest || copy.sequence > newest->sequence)) {
+            newest = &copy;
+        }
+    }
+    std::lock_guard<std::mutex> lock(tableMutex);
+    if (newest && newest->runs <= logRuns) {
+        table = *newest;
+    }
+    else {
+        // Nothing usable, or the log was replaced behind the index's back: rebuild from the log
+        std::uint64_t sequence = std::max(file.tables[0].sequence, file.tables[1].sequence);
+        std::memset(&table, 0, sizeof(table));
+        table.sequence = sequence;
+    }
+    if (!catchUp(logRuns)) {
+        std::cerr << "Failed to read leaderboard " << logPath << std::endl;
+        close();
+        return false;
+    }
+    changes++;
+    return true;
+}
+
+bool Leaderboard::catchUp(std::uint64_t logRuns) {
+    if (table.runs == logRuns) {
+        return true;
+    }
+    std::vector<RunRecord> block(std::min<std::uint64_t>(logRuns - table.runs, 4096));
+    while (table.runs < logRuns) {
+        std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(logRuns - table.runs, block.size()));
+        if (!log.read(sizeof(LogHeader) + table.runs * sizeof(RunRecord), block.data(), count * sizeof(RunRecord))) {
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            if (block[i].check != recordChecksum(block[i])) {
+                // Damaged, or not a run at all: nothing from here on can be trusted
+                std::cerr << "Dropping the last " << logRuns - table.runs << " runs from the leaderboard log, starting at one that fails its checksum" << std::endl;
+                if (!log.truncate(sizeof(LogHeader) + table.runs * sizeof(RunRecord))) {
+                    return false;
+                }
+                logRuns = table.runs;
+                break;
+            }
+            fold(block[i]);
+        }
+    }
+    storeTable();
+    return index.flush();
+}
+
+void Leaderboard::close() {
+    stop();
+    index.close();
+    log.close();
+}
+
+void Leaderboard::start() {
+    if (running() || !isOpen()) {
+        return;
+    }
+    stopping = false;
+    worker = std::thread(&Leaderboard::run, this);
+}
+
+void Leaderboard::stop() {
+    if (!running()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(control);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+bool Leaderboard::submit(const RunRecord& run) {
+    if (!isOpen()) {
+        return false;
+    }
+    if (!running()) {
+        return write(run);
+    }
+    if (!queue.push(run)) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(control);
+    }
+    wake.notify_one();
+    return true;
+}
+
+int Leaderboard::top(RunRecord* out, int max) const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    int count = std::min(max, static_cast<int>(table.count));
+    std::copy(table.entries, table.entries + count, out);
+    return count;
+}
+
+int Leaderboard::best() const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    return table.count > 0 ? table.entries[0].score : 0;
+}
+
+int Leaderboard::rankOf(int score) const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    int place = 0;
+    while (place < table.count && table.entries[place].score >= score) {
+        place++;
+    }
+    return place < LEADERBOARD_SIZE ? place + 1 : 0;
+}
+
+std::uint64_t Leaderboard::runs() const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    return table.runs;
+}
+
+bool Leaderboard::write(RunRecord run) {
+    // Into the log first and onto the device; only then does the run count
+    run.check = recordChecksum(run);
+    if (!log.append(&run, sizeof(run))) {
+        std::cerr << "Failed to record a run of score " << run.score << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        fold(run);
+        storeTable();
+    }
+    changes++;
+    return index.flush();
+}
+
+// Adds one logged run to the table. Runs tied on score keep the order they were played in.
+void Leaderboard::fold(const RunRecord& run) {
+    table.runs++;
+    int place = 0;
+    while (place < table.count && table.entries[place].score >= run.score) {
+        place++;
+    }
+    if (place == LEADERBOARD_SIZE) {
+        return;
+    }
+    int last = std::min(static_cast<int>(table.count), LEADERBOARD_SIZE - 1);
+    std::copy_backward(table.entries + place, table.entries + last, table.entries + last + 1);
+    table.entries[place] = run;
+    table.count = last + 1;
+}
+
+// Writes the table over the older of the two copies in the index
+void Leaderboard::storeTable() {
+    table.sequence++;
+    table.check = tableChecksum(table);
+    IndexFile& file = *reinterpret_cast<IndexFile*>(index.data());
+    file.tables[table.sequence % 2] = table;
+}
+
+void Leaderboard::run() {
+    std::unique_lock<std::mutex> lock(control);
+    for (;;) {
+        wake.wait(lock, [this]() { return stopping || queue.front() != nullptr; });
+        lock.unlock();
+
+        // Write without holding the lock, so submit() never waits on the disk
+        while (const RunRecord* run = queue.front()) {
+            write(*run);
+            queue.pop();
+        }
+
+        lock.lock();
+        if (stopping && !queue.front()) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "SpscQueue.h"
+#include "Storage.h"
+
+class GameWorld;
+
+// Persistent high scores. Every finished run is appended to a log (base path + ".log")
+// and the best LEADERBOARD_SIZE of them are kept in an index (base path + ".idx") that is
+// memory-mapped and read in place, so opening the board costs the same after ten runs as
+// after ten million.
+//
+// The log is the record of truth and only ever grows. The index holds two copies of the
+// table and each change overwrites the older one, so a crash mid-write leaves the other
+// intact; runs the log has but the index missed are folded back in on the next open.
+
+const int LEADERBOARD_SIZE = 100;
+
+// One finished run, laid out exactly as it is stored in the log and the index
+struct RunRecord {
+    std::uint64_t seed;          // Plays the run back together with its recorded inputs
+    std::int64_t time;           // Unix seconds when the run ended
+    std::int32_t score;
+    std::int32_t saucersJumped;
+    float height;                // Peak height reached, in HUD units
+    std::uint32_t check;         // Checksum of the fields above, so a torn write shows
+};
+
+static_assert(sizeof(RunRecord) == 32, "RunRecord is stored as is");
+
+// The run a world has just finished, stamped with the current time
+RunRecord finishedRun(const GameWorld& world, std::uint64_t seed);
+
+struct LeaderboardTable {
+    std::uint64_t sequence;      // Bumped on every write; the newer valid copy wins
+    std::uint64_t runs;          // Log records folded into this table
+    std::int32_t count;          // Entries in use, best first
+    std::uint32_t check;         // Checksum of every other field
+    RunRecord entries[LEADERBOARD_SIZE];
+};
+
+class Leaderboard {
+public:
+    static const int QUEUE_RUNS = 64;
+
+    Leaderboard();
+    ~Leaderboard();
+
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    // Opens or creates the board at basePath. Repairs a log cut short by a crash and
+    // brings the index up to date with it.
+    bool open(const std::string& basePath);
+    void close();
+
+    bool isOpen() const {
+        return log.isOpen();
+    }
+
+    // Without start() submit() writes inline; after it, a worker thread does the writing
+    // so a caller on the render thread never waits on the disk
+    void start();
+    void stop();  // Writes whatever is still queued first
+
+    bool running() const {
+        return worker.joinable();
+    }
+
+    // Records a run. Returns false if it could not be queued (or, inline, written).
+    bool submit(const RunRecord& run);
+
+    // Copies up to max of the best runs into out, best first, and returns how many
+    int top(RunRecord* out, int max) const;
+
+    int best() const;                // Highest score recorded, 0 if none
+    int rankOf(int score) const;     // Place (from 1) a run with score would take, 0 if off the table
+    std::uint64_t runs() const;      // Runs recorded in total
+
+    // Changes whenever the table does, so a view of it knows when to rebuild
+    unsigned int version() const {
+        return changes.load(std::memory_order_acquire);
+    }
+
+private:
+    AppendFile log;
+    MappedFile index;
+    LeaderboardTable table;          // Current table; written by one thread, guarded by tableMutex
+    mutable std::mutex tableMutex;
+    std::atomic<unsigned int> changes;
+
+    SpscQueue<RunRecord, QUEUE_RUNS> queue;
+    std::thread worker;
+    std::mutex control;
+    std::condition_variable wake;
+    bool stopping;                   // Guarded by control
+
+    bool write(RunRecord run);
+    void fold(const RunRecord& run);
+    void storeTable();
+    bool catchUp(std::uint64_t logRuns);
+    void run();
+};
@@ -0,0 +1,128 @@
+#include "LevelStreamer.h"
+#include "Rng.h"
+
+void generateChunk(std::uint64_t seed, int index, LevelChunk& chunk) {
+    RandomStream random(seed + static_cast<std::uint64_t>(index + 1) * 0x9E3779B97F4A7C15ull);
+    chunk.seed = seed;
+    chunk.index = index;
+    for (int i = 0; i < SAUCERS_PER_CHUNK; ++i) {
+        chunk.saucerX[i] = random.uniform(100, 700); // Saucer spawning positions
+        chunk.saucerY[i] = chunkBase(index) - i * SAUCER_SPACING;
+    }
+}
+
+LevelStreamer::LevelStreamer()
+    : streamed(0), inlined(0), requestedSeed(0), requestedIndex(0), requestEpoch(0), stopping(false) {}
+
+LevelStreamer::~LevelStreamer() {
+    stop();
+}
+
+void LevelStreamer::start() {
+    if (running()) {
+        return;
+    }
+    stopping = false;
+    worker = std::thread(&LevelStreamer::run, this);
+}
+
+void LevelStreamer::stop() {
+    if (!running()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(control);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void LevelStreamer::restart(std::uint64_t seed, int firstIndex) {
+    {
+        std::lock_guard<std::mutex> lock(control);
+        requestedSeed = seed;
+        requestedIndex = firstIndex;
+        requestEpoch++;
+    }
+    wake.notify_one();
+}
+
+void LevelStreamer::take(std::uint64_t seed, int index, LevelChunk& chunk) {
+    // Whatever the worker made for another level or for chunks already passed is stale
+    const LevelChunk* ready = queue.front();
+    while (ready && (ready->seed != seed || ready->index < index)) {
+        queue.pop();
+        ready = queue.front();
+    }
+
+    if (ready && ready->index == index) {
+        chunk = *ready;
+        queue.pop();
+        streamed++;
+    }
+    else {
+        generateChunk(seed, index, chunk);
+        inlined++;
+        if (running()) {
+            std::lock_guard<std::mutex> lock(control);
+            if (requestedSeed != seed) {
+                // The worker is building some other level; send it after this one
+                requestedSeed = seed;
+                requestedIndex = index + 1;
+                requestEpoch++;
+            }
+        }
+    }
+    if (running()) {
+        // There is room in the queue again. Passing through the lock first means the pops
+        // above cannot land between the worker finding the queue full and going to sleep,
+        // where this wake-up would be lost.
+        {
+            std::lock_guard<std::mutex> lock(control);
+        }
+        wake.notify_one();
+    }
+}
+
+void LevelStreamer::run() {
+    std::uint64_t seed = 0;
+    int next = 0;
+    unsigned int epoch = 0;
+    LevelChunk chunk;
+    bool pending = false;  // chunk is built but the queue was full
+
+    std::unique_lock<std::mutex> lock(control);
+    for (;;) {
+        wake.wait(lock, [&]() { return stopping || requestEpoch != epoch || !queue.full(); });
+        if (stopping) {
+            return;
+        }
+        if (requestEpoch != epoch) {
+            epoch = requestEpoch;
+            seed = requestedSeed;
+            next = requestedIndex;
+            pending = false;
+        }
+        lock.unlock();
+
+        // Fill the queue without holding the lock, so take() and restart() never wait on generation
+        for (;;) {
+            if (!pending) {
+                generateChunk(seed, next, chunk);
+                pending = true;
+            }
+            if (!queue.push(chunk)) {
+                break;
+            }
+            pending = false;
+            next++;
+
+            std::lock_guard<std::mutex> check(control);
+            if (stopping || requestEpoch != epoch) {
+                break;
+            }
+        }
+        lock.lock();
+    }
+}
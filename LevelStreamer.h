@@ -0,0 +1,78 @@
+#pragma once
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "SpscQueue.h"
+
+// The level above the camera is laid out in chunks one screen tall. A chunk's contents
+// depend only on the level seed and its index, so it can be generated ahead of time on a
+// worker thread and still come out exactly as if it had been generated on the spot.
+
+const float CHUNK_HEIGHT = 600.f;      // One screen
+const float LEVEL_BASE = 100.f;        // Lowest saucer of chunk 0, just above the starting saucers
+const float SAUCER_SPACING = 100.f;    // Vertical gap between saucers, within reach of a normal jump
+const int SAUCERS_PER_CHUNK = 6;
+
+struct LevelChunk {
+    std::uint64_t seed;
+    int index;
+    float saucerX[SAUCERS_PER_CHUNK];
+    float saucerY[SAUCERS_PER_CHUNK];
+};
+
+// Top y of the lowest saucer in chunk index
+inline float chunkBase(int index) {
+    return LEVEL_BASE - index * CHUNK_HEIGHT;
+}
+
+// Index of the chunk a saucer at y belongs to (the starting saucers are in chunk -1)
+inline int chunkOf(float y) {
+    return static_cast<int>(std::floor((LEVEL_BASE - y) / CHUNK_HEIGHT + 0.5f / SAUCERS_PER_CHUNK));
+}
+
+void generateChunk(std::uint64_t seed, int index, LevelChunk& chunk);
+
+// Hands out level chunks in order. Without start() every chunk is generated inline when
+// it is taken, which is what the headless tools use; after start() a worker thread keeps
+// the queue topped up ahead of the world, and take() only falls back to generating inline
+// when the worker has not got there yet (or the world jumped, e.g. a snapshot restore).
+class LevelStreamer {
+public:
+    static const int QUEUE_CHUNKS = 8;
+
+    unsigned int streamed;  // Chunks taken from the worker
+    unsigned int inlined;   // Chunks the caller had to generate itself
+
+    LevelStreamer();
+    ~LevelStreamer();
+
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+    void start();
+    void stop();
+
+    bool running() const {
+        return worker.joinable();
+    }
+
+    // Points the worker at a new level, starting from chunk firstIndex
+    void restart(std::uint64_t seed, int firstIndex);
+
+    // Fills chunk with chunk index of level seed
+    void take(std::uint64_t seed, int index, LevelChunk& chunk);
+
+private:
+    SpscQueue<LevelChunk, QUEUE_CHUNKS> queue;
+    std::thread worker;
+    std::mutex control;
+    std::condition_variable wake;
+    std::uint64_t requestedSeed;  // Guarded by control
+    int requestedIndex;           // Guarded by control
+    unsigned int requestEpoch;    // Guarded by control; bumped on every restart
+    bool stopping;                // Guarded by control
+
+    void run();
+};
@@ -0,0 +1,208 @@
+#include "Logger.h"
+#include <algorithm>
+#include <cstdarg>
+#include <iostream>
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+    case LOG_DEBUG: return "DEBUG";
+    case LOG_INFO: return "INFO";
+    case LOG_WARNING: return "WARN";
+    case LOG_ERROR: return "ERROR";
+    }
+    return "";
+}
+
+Logger::Logger()
+    : level(LOG_INFO), echo(false), epoch(std::chrono::steady_clock::now()), droppedRecords(0), reportedDrops(0),
+      nextAllowed(0), interval(0), tolerance(0), file(nullptr), fileBytes(0), maxBytes(0), keepFiles(0), threaded(false), pushing(0), stopping(false) {}
+
+Logger::~Logger() {
+    stop();
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool Logger::open(const std::string& logPath, std::uint64_t maxFileBytes, int keep) {
+    if (file) {
+        std::fclose(file);
+    }
+    path = logPath;
+    maxBytes = maxFileBytes;
+    keepFiles = keep;
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        std::cerr << "Failed to open log " << path << std::endl;
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    fileBytes = size > 0 ? static_cast<std::uint64_t>(size) : 0;
+    return true;
+}
+
+void Logger::start() {
+    if (worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(control);
+        stopping = false;
+    }
+    worker = std::thread(&Logger::run, this);
+    threaded.store(true, std::memory_order_release);
+}
+
+void Logger::stop() {
+    if (!worker.joinable()) {
+        return;
+    }
+    // From here on writers go inline. Those that already saw threaded are counted in
+    // pushing, so waiting for it to reach zero means their records are in the queue.
+    threaded.store(false);
+    {
+        std::lock_guard<std::mutex> lock(control);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    while (pushing.load() != 0) {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(inlineMutex);
+    drain();
+}
+
+void Logger::setRateLimit(float perSecond, float burst) {
+    interval = perSecond > 0 ? static_cast<std::int64_t>(1e9 / perSecond) : 0;
+    tolerance = static_cast<std::int64_t>(interval * std::max(burst - 1.0f, 0.0f));
+}
+
+bool Logger::allow(LogLevel recordLevel, std::int64_t now) {
+    if (interval == 0 || recordLevel >= LOG_WARNING) {
+        return true;
+    }
+    std::int64_t due = nextAllowed.load(std::memory_order_relaxed);
+    for (;;) {
+        std::int64_t from = std::max(due, now);
+        if (from - now > tolerance) {
+            return false;
+        }
+        if (nextAllowed.compare_exchange_weak(due, from + interval, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void Logger::write(LogLevel recordLevel, const char* format, ...) {
+    if (recordLevel < level) {
+        return;
+    }
+    LogRecord record;
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    if (!allow(recordLevel, record.time)) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    record.level = recordLevel;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+
+    // Sequentially consistent with stop(): either stop() sees this writer in pushing, or
+    // this writer sees threaded cleared and writes inline
+    pushing.fetch_add(1);
+    if (threaded.load()) {
+        if (!queue.push(record)) {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        }
+        pushing.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    pushing.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(inlineMutex);
+    output(record);
+    if (file) {
+        std::fflush(file);
+    }
+}
+
+void Logger::output(const LogRecord& record) {
+    char line[sizeof(record.text) + 32];
+    int length = std::snprintf(line, sizeof(line), "[%10.3f] %-5s %s\n", record.time * 1e-9, logLevelName(record.level), record.text);
+    length = std::min(length, static_cast<int>(sizeof(line)) - 1);
+    if (echo) {
+        std::fwrite(line, 1, length, record.level >= LOG_WARNING ? stderr : stdout);
+    }
+    if (!file) {
+        return;
+    }
+    if (maxBytes > 0 && fileBytes + length > maxBytes) {
+        rotate();
+        if (!file) {
+            return;
+        }
+    }
+    std::fwrite(line, 1, length, file);
+    fileBytes += length;
+}
+
+// path.(keepFiles - 1) becomes path.keepFiles, and so on down to path becoming path.1
+void Logger::rotate() {
+    std::fclose(file);
+    if (keepFiles > 0) {
+        std::remove((path + "." + std::to_string(keepFiles)).c_str());
+        for (int i = keepFiles - 1; i >= 1; --i) {
+            std::rename((path + "." + std::to_string(i)).c_str(), (path + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(path.c_str(), (path + ".1").c_str());
+    }
+    file = std::fopen(path.c_str(), "wb");
+    fileBytes = 0;
+}
+
+// Caller holds inlineMutex
+void Logger::drain() {
+    bool wrote = false;
+    while (const LogRecord* record = queue.front()) {
+        output(*record);
+        queue.pop();
+        wrote = true;
+    }
+    std::uint64_t drops = droppedRecords.load(std::memory_order_relaxed);
+    if (drops != reportedDrops) {
+        LogRecord note;
+        note.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+        note.level = LOG_WARNING;
+        std::snprintf(note.text, sizeof(note.text), "%llu log records dropped", static_cast<unsigned long long>(drops - reportedDrops));
+        output(note);
+        reportedDrops = drops;
+        wrote = true;
+    }
+    if (wrote) {
+        if (file) {
+            std::fflush(file);
+        }
+        if (echo) {
+            std::fflush(stdout);
+        }
+    }
+}
+
+// Producers never signal, so enqueueing stays free of locks; the worker polls instead,
+// often enough that records show up promptly and rarely enough to cost nothing
+void Logger::run() {
+    std::unique_lock<std::mutex> lock(control);
+    while (!stopping) {
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> writing(inlineMutex);
+            drain();
+        }
+        lock.lock();
+        wake.wait_for(lock, std::chrono::milliseconds(20), [this] { return stopping; });
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "MpscQueue.h"
+
+// Logging that never waits on a terminal or a disk. write() formats the message into a
+// fixed-size record on the caller's stack and pushes it onto a lock-free queue; a worker
+// thread takes records off and writes them to a log file that rotates once it grows past
+// a size limit, echoing them to stdout as well if asked. When messages come faster than
+// the rate limit, or the queue is full, they are dropped and counted, never waited on.
+// Without start() records are written inline instead, which suits the command-line tools.
+
+enum LogLevel {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR
+};
+
+const char* logLevelName(LogLevel level);
+
+struct LogRecord {
+    std::int64_t time;  // Nanoseconds since the logger was created
+    LogLevel level;
+    char text[116];     // Zero-terminated; longer messages are cut short
+};
+
+class Logger {
+public:
+    static const int QUEUE_RECORDS = 512;
+
+    LogLevel level;  // Records below this are discarded at the call site
+    bool echo;       // Also print records to stdout (from the worker once started)
+
+    Logger();
+    ~Logger();  // Writes out whatever is still queued
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Appends to path, keeping up to keepFiles older logs as path.1, path.2, ... once it
+    // reaches maxBytes. Without a file, records only go to stdout (if echo is set).
+    bool open(const std::string& path, std::uint64_t maxBytes = 1 << 20, int keepFiles = 3);
+
+    void start();
+    void stop();
+
+    bool running() const {
+        return threaded.load(std::memory_order_relaxed);
+    }
+
+    // Allows bursts of up to burst records, refilled at perSecond; warnings and errors are
+    // never limited. perSecond 0 turns limiting off.
+    void setRateLimit(float perSecond, float burst);
+
+    // printf-style. Safe to call from any thread.
+    void write(LogLevel level, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+    // Records dropped so far by the rate limit or a full queue
+    std::uint64_t dropped() const {
+        return droppedRecords.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::chrono::steady_clock::time_point epoch;
+    MpscQueue<LogRecord, QUEUE_RECORDS> queue;
+    std::atomic<std::uint64_t> droppedRecords;
+    std::uint64_t reportedDrops;  // Drops already noted in the log; guarded by inlineMutex
+
+    // Generic cell rate algorithm: the time the next record is due, in nanoseconds since
+    // epoch, may run ahead of now by at most burst intervals
+    std::atomic<std::int64_t> nextAllowed;
+    std::int64_t interval;
+    std::int64_t tolerance;
+
+    std::FILE* file;
+    std::string path;
+    std::uint64_t fileBytes;
+    std::uint64_t maxBytes;
+    int keepFiles;
+    std::mutex inlineMutex;  // Held around all output, by inline writes and by the worker's drains
+
+    std::thread worker;
+    std::atomic<bool> threaded;  // Whether write() hands records to the worker
+    std::atomic<int> pushing;    // Writers between checking threaded and finishing their push
+    std::mutex control;
+    std::condition_variable wake;
+    bool stopping;           // Guarded by control
+
+    bool allow(LogLevel level, std::int64_t now);
+    void output(const LogRecord& record);
+    void rotate();
+    void drain();
+    void run();
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded multi-producer single-consumer queue. Producers claim a cell with one
+// compare-and-swap and publish it through the cell's sequence number, so any thread can
+// push without locking or allocating; a full queue refuses the item instead of waiting.
+// Capacity must be a power of two.
+template <typename T, int Capacity>
+class MpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MpscQueue() : head(0), tail(0) {
+        for (int i = 0; i < Capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& item) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & (Capacity - 1)];
+            std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - position);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0) {
+                return false; // The consumer has not freed this cell yet: full
+            }
+            else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Oldest fully written item, or null if there is none yet. Consumer only.
+    const T* front() const {
+        const Cell& cell = cells[head & (Capacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+            return nullptr;
+        }
+        return &cell.item;
+    }
+
+    void pop() {
+        cells[head & (Capacity - 1)].sequence.store(head + Capacity, std::memory_order_release);
+        head++;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;  // position + 1 once written, position + Capacity once free again
+        T item;
+    };
+
+    std::array<Cell, Capacity> cells;
+    std::size_t head;               // Only the consumer touches this
+    std::atomic<std::size_t> tail;  // Next position producers will claim
+};
@@ -0,0 +1,30 @@
+// Packs the game's assets into the archive it maps at launch. The CMake build runs this
+// from the source directory, so each asset is stored under its plain file name:
+//
+//   build/bunny_pack build/assets.pak bunny.png saucer.png pixel-font.ttf arial.ttf
+//   build/bunny_pack --list build/assets.pak
+#include "AssetArchive.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--list") == 0) {
+        AssetArchive archive;
+        if (!archive.open(argv[2])) {
+            return 1;
+        }
+        for (int i = 0; i < archive.size(); ++i) {
+            const ArchiveEntry& entry = archive.entry(i);
+            std::printf("%-48s %10llu bytes at %llu\n", entry.name, static_cast<unsigned long long>(entry.size), static_cast<unsigned long long>(entry.offset));
+        }
+        return 0;
+    }
+    if (argc < 3 || argv[1][0] == '-') {
+        std::fprintf(stderr, "Usage: %s ARCHIVE FILE... | --list ARCHIVE\n", argv[0]);
+        return 1;
+    }
+    std::vector<std::string> files(argv + 2, argv + argc);
+    return packArchive(argv[1], files) ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+
+// Fixed-capacity object pool. Slots are handed out from a free list and stay at the
+// same index until released, so ids stored elsewhere (grids, attachments) remain
+// valid. Everything lives inline, so acquiring and releasing never touch the heap.
+template <typename T, int Capacity>
+class Pool {
+public:
+    Pool() {
+        clear();
+    }
+
+    void clear() {
+        for (int slot = 0; slot < Capacity; ++slot) {
+            used[slot] = false;
+            nextFree[slot] = slot + 1 < Capacity ? slot + 1 : -1;
+        }
+        freeHead = Capacity > 0 ? 0 : -1;
+        count = 0;
+    }
+
+    // Returns a free slot holding a default T, or -1 when the pool is exhausted
+    int acquire() {
+        if (freeHead < 0) {
+            return -1;
+        }
+        int slot = freeHead;
+        freeHead = nextFree[slot];
+        used[slot] = true;
+        items[slot] = T();
+        count++;
+        return slot;
+    }
+
+    void release(int slot) {
+        if (!used[slot]) {
+            return;
+        }
+        used[slot] = false;
+        nextFree[slot] = freeHead;
+        freeHead = slot;
+        count--;
+    }
+
+    bool alive(int slot) const {
+        return used[slot];
+    }
+
+    T& operator[](int slot) {
+        return items[slot];
+    }
+
+    const T& operator[](int slot) const {
+        return items[slot];
+    }
+
+    int size() const {
+        return count;
+    }
+
+    static constexpr int capacity() {
+        return Capacity;
+    }
+
+    // Calls visit(slot, item) for every live slot, in slot order
+    template <typename Visitor>
+    void forEach(Visitor visit) {
+        for (int slot = 0; slot < Capacity; ++slot) {
+            if (used[slot]) {
+                visit(slot, items[slot]);
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (int slot = 0; slot < Capacity; ++slot) {
+            if (used[slot]) {
+                visit(slot, items[slot]);
+            }
+        }
+    }
+
+private:
+    std::array<T, Capacity> items;
+    std::array<int, Capacity> nextFree;
+    std::array<bool, Capacity> used;
+    int freeHead;
+    int count;
+};
@@ -0,0 +1,96 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+const char* phaseName(ProfilePhase phase) {
+    switch (phase) {
+    case PHASE_FRAME: return "frame";
+    case PHASE_EVENTS: return "events";
+    case PHASE_SIMULATION: return "simulation";
+    case PHASE_TIMERS: return "timers";
+    case PHASE_COINS: return "coins";
+    case PHASE_SAUCERS: return "saucers";
+    case PHASE_BUNNY: return "bunny";
+    case PHASE_STREAMING: return "streaming";
+    case PHASE_RENDER: return "render";
+    case PHASE_HUD: return "hud";
+    case PHASE_DISPLAY: return "display";
+    case PHASE_COUNT: break;
+    }
+    return "";
+}
+
+Profiler::Profiler() : epoch(std::chrono::steady_clock::now()), samples(CAPACITY), head(0), frame(0) {
+    scratch.reserve(CAPACITY);
+}
+
+void Profiler::summarize(PhaseStats* stats, int frames) const {
+    const std::uint64_t end = head.load(std::memory_order_acquire);
+    const std::uint64_t begin = oldest(end);
+
+    // Newest samples first, stopping at the first one older than the window
+    std::uint64_t windowBegin = end;
+    while (windowBegin > begin && frame - samples[(windowBegin - 1) & (CAPACITY - 1)].frame < static_cast<std::uint32_t>(frames)) {
+        windowBegin--;
+    }
+
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        scratch.clear();
+        for (std::uint64_t i = windowBegin; i < end; ++i) {
+            const ProfileSample& sample = samples[i & (CAPACITY - 1)];
+            if (sample.phase == static_cast<std::uint32_t>(phase)) {
+                scratch.push_back(sample.duration);
+            }
+        }
+
+        PhaseStats& out = stats[phase];
+        out.count = static_cast<int>(scratch.size());
+        out.p50 = out.p99 = out.max = 0;
+        if (scratch.empty()) {
+            continue;
+        }
+        auto percentile = [&](double fraction) {
+            auto nth = scratch.begin() + static_cast<std::ptrdiff_t>(fraction * (scratch.size() - 1));
+            std::nth_element(scratch.begin(), nth, scratch.end());
+            return *nth / 1e6;
+        };
+        out.p50 = percentile(0.5);
+        out.p99 = percentile(0.99);
+        out.max = *std::max_element(scratch.begin(), scratch.end()) / 1e6;
+    }
+}
+
+bool Profiler::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to write profile " << path << std::endl;
+        return false;
+    }
+
+    const std::uint64_t end = head.load(std::memory_order_acquire);
+    const bool chromeTrace = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (chromeTrace) {
+        // Complete events ("ph":"X") with timestamps and durations in microseconds
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[\n";
+        for (std::uint64_t i = oldest(end); i < end; ++i) {
+            const ProfileSample& sample = samples[i & (CAPACITY - 1)];
+            out << "{\"name\":\"" << phaseName(static_cast<ProfilePhase>(sample.phase))
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << sample.start / 1000.0
+                << ",\"dur\":" << sample.duration / 1000.0
+                << ",\"args\":{\"frame\":" << sample.frame << "}}" << (i + 1 < end ? ",\n" : "\n");
+        }
+        out << "]}\n";
+    }
+    else {
+        out << "frame,phase,start_ns,duration_ns\n";
+        for (std::uint64_t i = oldest(end); i < end; ++i) {
+            const ProfileSample& sample = samples[i & (CAPACITY - 1)];
+            out << sample.frame << ',' << phaseName(static_cast<ProfilePhase>(sample.phase)) << ','
+                << sample.start << ',' << sample.duration << '\n';
+        }
+    }
+    return static_cast<bool>(out);
+}
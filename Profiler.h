@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame profiler. Code marks its phases with ProfileScope; every finished scope becomes
+// one sample in a fixed ring buffer, so profiling never allocates and always holds the
+// most recent CAPACITY samples. Headless like GameWorld: the overlay lives in main.cpp.
+
+enum ProfilePhase {
+    PHASE_FRAME,       // One whole pass of the main loop
+    PHASE_EVENTS,      // Window event polling and menu clicks
+    PHASE_SIMULATION,  // All fixed ticks run this frame
+    PHASE_TIMERS,      // Tick timers firing: power-up and coin spawns, power-up expiry
+    PHASE_COINS,       // Coin pickups
+    PHASE_SAUCERS,     // Saucer movement, landing and power-up pickups
+    PHASE_BUNNY,       // Bunny::update and its swept move
+    PHASE_STREAMING,   // Camera follow, streaming level chunks in and retiring passed ones
+    PHASE_RENDER,      // Drawing the world
+    PHASE_HUD,         // Building and drawing HUD text
+    PHASE_DISPLAY,     // window.display(), including any vsync or frame limit wait
+    PHASE_COUNT
+};
+
+const char* phaseName(ProfilePhase phase);
+
+struct ProfileSample {
+    std::uint32_t frame;
+    std::uint32_t phase;
+    std::int64_t start;     // Nanoseconds since the profiler was created
+    std::int64_t duration;  // Nanoseconds
+};
+
+// Rolling statistics for one phase, in milliseconds
+struct PhaseStats {
+    int count;
+    double p50;
+    double p99;
+    double max;
+};
+
+class Profiler {
+public:
+    static const int CAPACITY = 1 << 16;  // Samples kept; a power of two
+
+    Profiler();
+
+    std::int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void beginFrame() {
+        frame++;
+    }
+
+    std::uint32_t currentFrame() const {
+        return frame;
+    }
+
+    // Publishes one sample. Single writer, and slots are reused without any guard, so
+    // summarize() and save() belong on the writer's thread: a reader elsewhere could see a
+    // sample half overwritten once the ring wraps.
+    void record(ProfilePhase phase, std::int64_t start, std::int64_t end) {
+        std::uint64_t index = head.load(std::memory_order_relaxed);
+        ProfileSample& sample = samples[index & (CAPACITY - 1)];
+        sample.frame = frame;
+        sample.phase = phase;
+        sample.start = start;
+        sample.duration = end - start;
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    // Fills stats[PHASE_COUNT] from the samples of the last frames frames
+    void summarize(PhaseStats* stats, int frames = 120) const;
+
+    // Writes every sample still in the ring: Chrome trace JSON (chrome://tracing, Perfetto)
+    // if path ends in .json, CSV otherwise
+    bool save(const std::string& path) const;
+
+private:
+    std::chrono::steady_clock::time_point epoch;
+    std::vector<ProfileSample> samples;
+    std::atomic<std::uint64_t> head;  // Total samples ever recorded
+    std::uint32_t frame;
+    mutable std::vector<std::int64_t> scratch;  // Durations of one phase while summarizing
+
+    // Index of the oldest sample still in the ring
+    std::uint64_t oldest(std::uint64_t end) const {
+        return end > static_cast<std::uint64_t>(CAPACITY) ? end - CAPACITY : 0;
+    }
+};
+
+// Times the enclosing scope as one phase. profiler may be null, which turns it into a no-op.
+class ProfileScope {
+public:
+    ProfileScope(Profiler* profiler, ProfilePhase phase)
+        : profiler(profiler), phase(phase), start(profiler ? profiler->now() : 0) {}
+
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->record(phase, start, profiler->now());
+        }
+    }
+
+    // Ends the current phase and starts timing the next one, for code that runs in stages
+    void switchTo(ProfilePhase next) {
+        if (profiler) {
+            std::int64_t time = profiler->now();
+            profiler->record(phase, start, time);
+            start = time;
+        }
+        phase = next;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler* profiler;
+    ProfilePhase phase;
+    std::int64_t start;
+};
@@ -0,0 +1,154 @@
+#include "Replay.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+// File layout, all integers little-endian:
+//   "BJRP", u16 version, u64 seed, f32 tick rate, u32 tick count,
+//   i32 score, i32 saucers jumped, f32 min height, u8 game over,
+//   u32 run count, then one byte per run: input bits in the low 3, run length - 1 in the high 5
+static const char REPLAY_MAGIC[4] = { 'B', 'J', 'R', 'P' };
+static const std::uint16_t REPLAY_VERSION = 1;
+static const int MAX_RUN = 32;
+
+static void writeBytes(std::ofstream& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static std::uint64_t readBytes(std::ifstream& in, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in.get())) << (8 * i);
+    }
+    return value;
+}
+
+static std::uint32_t floatBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(std::uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void Replay::finish(const GameWorld& world) {
+    finalScore = world.stats.score;
+    finalSaucersJumped = world.stats.saucersJumped;
+    finalMinHeight = world.minHeight;
+    finalGameOver = world.gameOver;
+}
+
+bool Replay::matches(const GameWorld& world) const {
+    return world.stats.score == finalScore && world.stats.saucersJumped == finalSaucersJumped
+        && world.minHeight == finalMinHeight && world.gameOver == finalGameOver;
+}
+
+void Replay::play(GameWorld& world) const {
+    world.reset(seed);
+    const float deltaTime = 1.f / tickRate;
+    for (std::uint8_t bits : inputs) {
+        if (world.profiler) {
+            world.profiler->beginFrame(); // Headless, each tick counts as a frame
+        }
+        ProfileScope tick(world.profiler, PHASE_SIMULATION);
+        world.step(unpackInput(bits), deltaTime);
+    }
+}
+
+bool Replay::save(const std::string& path) const {
+    std::vector<std::uint8_t> runs;
+    for (std::size_t i = 0; i < inputs.size();) {
+        std::size_t length = 1;
+        while (length < MAX_RUN && i + length < inputs.size() && inputs[i + length] == inputs[i]) {
+            length++;
+        }
+        runs.push_back(static_cast<std::uint8_t>(inputs[i] | ((length - 1) << 3)));
+        i += length;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to write replay " << path << std::endl;
+        return false;
+    }
+    out.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    writeBytes(out, REPLAY_VERSION, 2);
+    writeBytes(out, seed, 8);
+    writeBytes(out, floatBits(tickRate), 4);
+    writeBytes(out, inputs.size(), 4);
+    writeBytes(out, static_cast<std::uint32_t>(finalScore), 4);
+    writeBytes(out, static_cast<std::uint32_t>(finalSaucersJumped), 4);
+    writeBytes(out, floatBits(finalMinHeight), 4);
+    writeBytes(out, finalGameOver ? 1 : 0, 1);
+    writeBytes(out, runs.size(), 4);
+    out.write(reinterpret_cast<const char*>(runs.data()), runs.size());
+    return static_cast<bool>(out);
+}
+
+bool Replay::load(const std::string& path, std::size_t maxTicks) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to open replay " << path << std::endl;
+        return false;
+    }
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 || readBytes(in, 2) != REPLAY_VERSION) {
+        std::cerr << path << " is not a version " << REPLAY_VERSION << " replay" << std::endl;
+        return false;
+    }
+    // Read into a copy so a file that turns out to be bad leaves this replay as it was
+    Replay loaded;
+    loaded.seed = readBytes(in, 8);
+    loaded.tickRate = bitsFloat(static_cast<std::uint32_t>(readBytes(in, 4)));
+    std::size_t ticks = static_cast<std::size_t>(readBytes(in, 4));
+    loaded.finalScore = static_cast<std::int32_t>(readBytes(in, 4));
+    loaded.finalSaucersJumped = static_cast<std::int32_t>(readBytes(in, 4));
+    loaded.finalMinHeight = bitsFloat(static_cast<std::uint32_t>(readBytes(in, 4)));
+    loaded.finalGameOver = readBytes(in, 1) != 0;
+    std::size_t runCount = static_cast<std::size_t>(readBytes(in, 4));
+
+    // Both counts come from the file, so check them against its length before sizing
+    // anything by them: every run is one byte and covers between 1 and MAX_RUN ticks
+    std::streamoff runsStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff remaining = in.tellg() - runsStart;
+    in.seekg(runsStart);
+    if (!in || !(loaded.tickRate > 0) || static_cast<std::streamoff>(runCount) > remaining) {
+        std::cerr << "Replay " << path << " is truncated" << std::endl;
+        return false;
+    }
+    if (ticks < runCount || ticks > runCount * MAX_RUN) {
+        std::cerr << "Replay " << path << " cannot hold " << ticks << " ticks in " << runCount << " runs" << std::endl;
+        return false;
+    }
+    if (ticks > maxTicks) {
+        std::cerr << "Replay " << path << " is " << ticks << " ticks long, more than the " << maxTicks << " allowed" << std::endl;
+        return false;
+    }
+
+    std::vector<std::uint8_t> runs(runCount);
+    in.read(reinterpret_cast<char*>(runs.data()), runs.size());
+    if (!in) {
+        std::cerr << "Replay " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    loaded.inputs.reserve(ticks);
+    for (std::uint8_t run : runs) {
+        loaded.inputs.insert(loaded.inputs.end(), (run >> 3) + 1, static_cast<std::uint8_t>(run & 7));
+    }
+    if (loaded.inputs.size() != ticks) {
+        std::cerr << "Replay " << path << " holds " << loaded.inputs.size() << " ticks, expected " << ticks << std::endl;
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GameWorld.h"
+
+// Input recording and playback. A run is fully determined by its seed, its tick rate and
+// the InputState of every tick, so storing those is enough to play it back exactly.
+
+enum InputBit {
+    INPUT_JUMP = 1,
+    INPUT_LEFT = 2,
+    INPUT_RIGHT = 4
+};
+
+inline std::uint8_t packInput(const InputState& input) {
+    return static_cast<std::uint8_t>((input.jump ? INPUT_JUMP : 0) | (input.left ? INPUT_LEFT : 0) | (input.right ? INPUT_RIGHT : 0));
+}
+
+inline InputState unpackInput(std::uint8_t bits) {
+    InputState input;
+    input.jump = (bits & INPUT_JUMP) != 0;
+    input.left = (bits & INPUT_LEFT) != 0;
+    input.right = (bits & INPUT_RIGHT) != 0;
+    return input;
+}
+
+// One recorded run together with the stats it ended on, so playing it back doubles as a
+// regression check. On disk the inputs are run-length encoded: held keys cost one byte
+// per 32 ticks instead of one per tick.
+class Replay {
+public:
+    std::uint64_t seed;
+    float tickRate;
+    std::vector<std::uint8_t> inputs;  // One packInput bitmask per tick
+
+    // State of the world after the last recorded tick
+    int finalScore;
+    int finalSaucersJumped;
+    float finalMinHeight;
+    bool finalGameOver;
+
+    Replay() : seed(0), tickRate(SIM_TICK_RATE), finalScore(0), finalSaucersJumped(0), finalMinHeight(0), finalGameOver(false) {}
+
+    // Starts a new recording. Reserves room for reserveTicks so recording does not allocate.
+    void begin(std::uint64_t runSeed, float runTickRate, std::size_t reserveTicks = 0) {
+        seed = runSeed;
+        tickRate = runTickRate;
+        inputs.clear();
+        inputs.reserve(reserveTicks);
+    }
+
+    void record(const InputState& input) {
+        inputs.push_back(packInput(input));
+    }
+
+    // Captures the stats the recording is expected to reproduce
+    void finish(const GameWorld& world);
+
+    // Whether world ended up exactly where the recording did
+    bool matches(const GameWorld& world) const;
+
+    // Resets world to the recorded seed and steps it through every recorded tick,
+    // timing each one as a frame if the world has a profiler
+    void play(GameWorld& world) const;
+
+    bool save(const std::string& path) const;
+    // Refuses files claiming more than maxTicks ticks, checked before anything is allocated
+    bool load(const std::string& path, std::size_t maxTicks = SIZE_MAX);
+
+    float seconds() const {
+        return inputs.size() / tickRate;
+    }
+};
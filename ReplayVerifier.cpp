@@ -0,0 +1,102 @@
+#include "ReplayVerifier.h"
+#include <chrono>
+
+const char* verifyStatusName(VerifyStatus status) {
+    switch (status) {
+    case VERIFY_ACCEPTED: return "accepted";
+    case VERIFY_MISMATCH: return "mismatch";
+    case VERIFY_MALFORMED: return "malformed";
+    }
+    return "";
+}
+
+VerifyStatus verifyReplay(const Replay& replay, GameWorld& world, int& score) {
+    score = 0;
+    if (!(replay.tickRate >= MIN_VERIFY_TICK_RATE && replay.tickRate <= MAX_VERIFY_TICK_RATE)
+        || replay.seconds() > MAX_VERIFY_SECONDS) {
+        return VERIFY_MALFORMED;
+    }
+    replay.play(world);
+    score = world.stats.score;
+    return replay.matches(world) ? VERIFY_ACCEPTED : VERIFY_MISMATCH;
+}
+
+ReplayVerifier::ReplayVerifier(int threadCount, int queueCapacity)
+    : capacity(queueCapacity > 0 ? queueCapacity : 1), busy(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threadCount <= 0) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ReplayVerifier::run, this);
+    }
+}
+
+ReplayVerifier::~ReplayVerifier() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ReplayVerifier::submit(std::uint64_t id, Replay&& replay) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return jobs.size() < capacity; });
+        jobs.push_back(Job{ id, std::move(replay) });
+    }
+    notEmpty.notify_one();
+}
+
+bool ReplayVerifier::poll(VerifyResult& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (results.empty()) {
+        return false;
+    }
+    result = results.front();
+    results.pop_front();
+    return true;
+}
+
+void ReplayVerifier::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return jobs.empty() && busy == 0; });
+}
+
+void ReplayVerifier::run() {
+    GameWorld world(0); // Reset to each replay's seed before it is played
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return; // Stopping, and everything queued is done
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            busy++;
+        }
+        notFull.notify_one();
+
+        VerifyResult result;
+        result.id = job.id;
+        result.claimedScore = job.replay.finalScore;
+        auto start = std::chrono::steady_clock::now();
+        result.status = verifyReplay(job.replay, world, result.score);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(result);
+            busy--;
+        }
+        done.notify_all();
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Replay.h"
+
+// Checks submitted runs by playing them again. A replay carries its seed, its inputs and
+// the stats the player claims it ended on; the game is deterministic, so stepping a fresh
+// GameWorld through the same inputs must land on exactly those stats or the claim is false.
+
+// Limits on what a submission may ask the verifier to simulate
+const float MIN_VERIFY_TICK_RATE = 10.f;
+const float MAX_VERIFY_TICK_RATE = 1000.f;
+const float MAX_VERIFY_SECONDS = 60 * 60.f;
+const std::size_t MAX_VERIFY_TICKS = static_cast<std::size_t>(MAX_VERIFY_SECONDS * MAX_VERIFY_TICK_RATE);
+
+enum VerifyStatus {
+    VERIFY_ACCEPTED,   // Re-simulation reproduced every claimed stat
+    VERIFY_MISMATCH,   // The inputs do not lead to the claimed stats
+    VERIFY_MALFORMED   // Unreadable, or outside the limits above
+};
+
+const char* verifyStatusName(VerifyStatus status);
+
+struct VerifyResult {
+    std::uint64_t id;   // As given to submit()
+    VerifyStatus status;
+    int claimedScore;
+    int score;          // What the inputs actually score
+    double seconds;     // Time spent re-simulating
+};
+
+// Re-simulates replay on world, which is reset first, and compares it with its claim
+VerifyStatus verifyReplay(const Replay& replay, GameWorld& world, int& score);
+
+// Verifies replays on a fixed set of worker threads, each with its own GameWorld. The work
+// queue is bounded: submit() blocks while it is full, so a flood of submissions is held
+// back at the door instead of piling up in memory. Results are collected with poll().
+class ReplayVerifier {
+public:
+    explicit ReplayVerifier(int threadCount = 0, int queueCapacity = 256);
+    ~ReplayVerifier();  // Finishes what is queued first
+
+    ReplayVerifier(const ReplayVerifier&) = delete;
+    ReplayVerifier& operator=(const ReplayVerifier&) = delete;
+
+    int size() const {
+        return static_cast<int>(threads.size());
+    }
+
+    // Queues replay, waiting for room if the queue is full
+    void submit(std::uint64_t id, Replay&& replay);
+
+    // Takes one finished result, if there is one
+    bool poll(VerifyResult& result);
+
+    // Blocks until every submitted replay has a result waiting in poll()
+    void wait();
+
+private:
+    struct Job {
+        std::uint64_t id;
+        Replay replay;
+    };
+
+    std::vector<std::thread> threads;
+    std::size_t capacity;
+    std::mutex mutex;
+    std::deque<Job> jobs;                // Guarded by mutex, at most capacity long
+    std::deque<VerifyResult> results;    // Guarded by mutex
+    int busy;                            // Jobs taken off the queue and still running
+    bool stopping;
+    std::condition_variable notEmpty;    // Signalled when a job arrives or on shutdown
+    std::condition_variable notFull;     // Signalled when a worker takes a job
+    std::condition_variable done;        // Signalled when a result is added
+
+    void run();
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include "AssetArchive.h"
+
+// Loads each file at most once and hands out shared handles to it. The handles stay
+// valid for as long as anyone holds them, so sprites never point at a freed texture.
+// Works for any SFML resource with loadFromFile and loadFromMemory (sf::Texture, sf::Font,
+// sf::SoundBuffer). With an archive set, assets it holds are loaded straight from its
+// mapping; sf::Font keeps reading from that memory, so the archive must outlive the cache.
+template <typename Resource>
+class ResourceCache {
+public:
+    typedef std::shared_ptr<Resource> Handle;
+
+    unsigned int hits;    // Requests served from memory
+    unsigned int misses;  // Requests that had to be loaded
+    unsigned int packed;  // Misses loaded from the archive rather than a loose file
+    double loadSeconds;   // Time spent loading misses
+
+    ResourceCache() : hits(0), misses(0), packed(0), loadSeconds(0), archive(nullptr) {}
+
+    void setArchive(const AssetArchive* assets) {
+        archive = assets;
+    }
+
+    // Returns the cached resource for path, loading it on first use. Null if loading failed.
+    Handle get(const std::string& path) {
+        auto found = resources.find(path);
+        if (found != resources.end()) {
+            hits++;
+            return found->second;
+        }
+
+        misses++;
+        auto start = std::chrono::steady_clock::now();
+        Handle resource = std::make_shared<Resource>();
+        std::size_t size = 0;
+        const void* data = archive ? archive->find(path, size) : nullptr;
+        bool loaded = data ? resource->loadFromMemory(data, size) : resource->loadFromFile(path);
+        loadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!loaded) {
+            std::cerr << "Failed to load " << path << std::endl;
+            return Handle();
+        }
+        packed += data ? 1 : 0;
+        resources[path] = resource;
+        return resource;
+    }
+
+    // Frees every resource nobody outside the cache holds a handle to
+    std::size_t purgeUnused() {
+        std::size_t purged = 0;
+        for (auto it = resources.begin(); it != resources.end();) {
+            if (it->second.use_count() == 1) {
+                it = resources.erase(it);
+                purged++;
+            }
+            else {
+                ++it;
+            }
+        }
+        return purged;
+    }
+
+    std::size_t size() const {
+        return resources.size();
+    }
+
+private:
+    std::map<std::string, Handle> resources;
+    const AssetArchive* archive;
+};
+
+// All assets the game uses, shared between the menu, the HUD and the world renderer
+class Resources {
+public:
+    AssetArchive archive;  // Declared first so it is unmapped only after the caches are gone
+    ResourceCache<sf::Texture> textures;
+    ResourceCache<sf::Font> fonts;
+
+    // Serves assets from the archive at path where it has them. Without one, or for
+    // anything it lacks, the caches fall back to loose files.
+    bool openArchive(const std::string& path) {
+        if (!archive.open(path)) {
+            return false;
+        }
+        textures.setArchive(&archive);
+        fonts.setArchive(&archive);
+        return true;
+    }
+
+    void printStats(std::ostream& out) const {
+        out << "Textures: " << textures.size() << " loaded (" << textures.packed << " from the archive) in " << textures.loadSeconds * 1e3 << " ms, "
+            << textures.hits << " hits, " << textures.misses << " misses\n";
+        out << "Fonts: " << fonts.size() << " loaded (" << fonts.packed << " from the archive) in " << fonts.loadSeconds * 1e3 << " ms, "
+            << fonts.hits << " hits, " << fonts.misses << " misses\n";
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+
+// Random numbers for the simulation. Everything random in a run comes from one Rng seeded
+// once, so the same seed and the same inputs always build the same level on every
+// platform (the standard library distributions are implementation-defined, these are not).
+
+// One xoshiro128** generator: 16 bytes of state and a handful of shifts per number
+class RandomStream {
+public:
+    explicit RandomStream(std::uint64_t seedValue = 0) {
+        seed(seedValue);
+    }
+
+    // Expands a 64-bit seed into the full state with splitmix64, as the xoshiro authors recommend
+    void seed(std::uint64_t seedValue) {
+        for (int i = 0; i < 4; i += 2) {
+            std::uint64_t z = (seedValue += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            state[i] = static_cast<std::uint32_t>(z);
+            state[i + 1] = static_cast<std::uint32_t>(z >> 32);
+        }
+    }
+
+    std::uint32_t next() {
+        const std::uint32_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+        return result;
+    }
+
+    // Uniform float in [min, max)
+    float uniform(float min, float max) {
+        return min + (max - min) * ((next() >> 8) * (1.f / 16777216.f));
+    }
+
+    // Uniform int in [min, max], without modulo bias
+    int range(int min, int max) {
+        const std::uint32_t span = static_cast<std::uint32_t>(max - min) + 1;
+        std::uint64_t product = static_cast<std::uint64_t>(next()) * span;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < span) {
+            const std::uint32_t threshold = (0u - span) % span;
+            while (low < threshold) {
+                product = static_cast<std::uint64_t>(next()) * span;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return min + static_cast<int>(product >> 32);
+    }
+
+private:
+    std::uint32_t state[4];
+
+    static std::uint32_t rotl(std::uint32_t value, int bits) {
+        return (value << bits) | (value >> (32 - bits));
+    }
+};
+
+// The named streams the world draws from. Each is seeded independently from the run
+// seed, so e.g. adding a coin draw does not shift where every later saucer appears.
+class Rng {
+public:
+    std::uint64_t seedValue;  // The seed the streams were last derived from
+    RandomStream saucers;     // Saucer spawn positions
+    RandomStream coins;       // Coin spawn positions
+    RandomStream powerUps;    // Power-up types
+
+    explicit Rng(std::uint64_t seedValue = 0) {
+        seed(seedValue);
+    }
+
+    void seed(std::uint64_t value) {
+        seedValue = value;
+        saucers.seed(value ^ 0x5A5CE25A5CE25A5Cull);
+        coins.seed(value ^ 0xC0114C0114C0114Cull);
+        powerUps.seed(value ^ 0x90E2090E2090E209ull);
+    }
+};
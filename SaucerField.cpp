@@ -0,0 +1,168 @@
+#include "SaucerField.h"
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SAUCER_KERNEL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SAUCER_KERNEL_SSE2
+#endif
+
+SaucerField::SaucerField(int capacity) : head(0), tail(0) {
+    int rounded = 1;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    mask = rounded - 1;
+    x.resize(rounded);
+    y.resize(rounded);
+    width.resize(rounded);
+    height.resize(rounded);
+    speed.resize(rounded);
+    direction.resize(rounded);
+    previousX.resize(rounded);
+    powerUp.resize(rounded, -1);
+}
+
+void SaucerField::clear() {
+    head = 0;
+    tail = 0;
+}
+
+int SaucerField::add(float left, float top, float w, float h, float pixelsPerSecond) {
+    int serial = tail++;
+    int i = slot(serial);
+    x[i] = left;
+    y[i] = top;
+    width[i] = w;
+    height[i] = h;
+    speed[i] = pixelsPerSecond;
+    direction[i] = -1;
+    previousX[i] = left;
+    powerUp[i] = -1;
+    return serial;
+}
+
+void SaucerField::popFront() {
+    head++;
+}
+
+void SaucerField::update(float deltaTime, float boundary) {
+    // The live saucers are at most two contiguous runs of the ring
+    std::size_t first = slot(head);
+    std::size_t count = size();
+    std::size_t firstRun = std::min(count, static_cast<std::size_t>(capacity()) - first);
+    moveSaucers(x.data() + first, direction.data() + first, speed.data() + first, width.data() + first,
+        firstRun, deltaTime, boundary);
+    moveSaucers(x.data(), direction.data(), speed.data(), width.data(), count - firstRun, deltaTime, boundary);
+}
+
+void SaucerField::storePreviousPositions() {
+    for (int serial = head; serial != tail; ++serial) {
+        previousX[slot(serial)] = x[slot(serial)];
+    }
+}
+
+void moveSaucersScalar(float* x, float* direction, const float* speed, const float* width,
+    std::size_t begin, std::size_t end, float deltaTime, float boundary) {
+    for (std::size_t i = begin; i < end; ++i) {
+        x[i] += speed[i] * direction[i] * deltaTime; // Move saucer horizontally
+
+        // Reverse direction at screen boundaries
+        if (x[i] + width[i] < 0 && direction[i] < 0) {
+            direction[i] = 1;
+            x[i] = 0;
+        }
+        else if (x[i] > boundary && direction[i] > 0) {
+            direction[i] = -1;
+            x[i] = boundary - width[i];
+        }
+    }
+}
+
+#if defined(SAUCER_KERNEL_AVX)
+
+void moveSaucers(float* x, float* direction, const float* speed, const float* width,
+    std::size_t count, float deltaTime, float boundary) {
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 right = _mm256_set1_ps(boundary);
+    const __m256 signBit = _mm256_set1_ps(-0.f);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 dir = _mm256_loadu_ps(direction + i);
+        __m256 w = _mm256_loadu_ps(width + i);
+        px = _mm256_add_ps(px, _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(speed + i), dir), dt));
+
+        // Same conditions as the scalar loop, evaluated for all lanes at once
+        __m256 offLeft = _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(px, w), zero, _CMP_LT_OQ), _mm256_cmp_ps(dir, zero, _CMP_LT_OQ));
+        __m256 offRight = _mm256_andnot_ps(offLeft, _mm256_and_ps(_mm256_cmp_ps(px, right, _CMP_GT_OQ), _mm256_cmp_ps(dir, zero, _CMP_GT_OQ)));
+        __m256 bounced = _mm256_or_ps(offLeft, offRight);
+
+        // Plain bitwise selects; vblendvps is slower than and/andnot/or on many cores
+        px = _mm256_andnot_ps(offLeft, px);
+        px = _mm256_or_ps(_mm256_and_ps(offRight, _mm256_sub_ps(right, w)), _mm256_andnot_ps(offRight, px));
+        dir = _mm256_xor_ps(dir, _mm256_and_ps(bounced, signBit));
+
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(direction + i, dir);
+    }
+    moveSaucersScalar(x, direction, speed, width, i, count, deltaTime, boundary);
+}
+
+const char* saucerKernelName() {
+    return "avx";
+}
+
+#elif defined(SAUCER_KERNEL_SSE2)
+
+// SSE2 has no blend instruction, so select with and/andnot/or
+static inline __m128 select(__m128 mask, __m128 ifTrue, __m128 ifFalse) {
+    return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+void moveSaucers(float* x, float* direction, const float* speed, const float* width,
+    std::size_t count, float deltaTime, float boundary) {
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 right = _mm_set1_ps(boundary);
+    const __m128 signBit = _mm_set1_ps(-0.f);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 dir = _mm_loadu_ps(direction + i);
+        __m128 w = _mm_loadu_ps(width + i);
+        px = _mm_add_ps(px, _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(speed + i), dir), dt));
+
+        // Same conditions as the scalar loop, evaluated for all lanes at once
+        __m128 offLeft = _mm_and_ps(_mm_cmplt_ps(_mm_add_ps(px, w), zero), _mm_cmplt_ps(dir, zero));
+        __m128 offRight = _mm_andnot_ps(offLeft, _mm_and_ps(_mm_cmpgt_ps(px, right), _mm_cmpgt_ps(dir, zero)));
+
+        px = _mm_andnot_ps(offLeft, px);
+        px = select(offRight, _mm_sub_ps(right, w), px);
+        dir = _mm_xor_ps(dir, _mm_and_ps(_mm_or_ps(offLeft, offRight), signBit));
+
+        _mm_storeu_ps(x + i, px);
+        _mm_storeu_ps(direction + i, dir);
+    }
+    moveSaucersScalar(x, direction, speed, width, i, count, deltaTime, boundary);
+}
+
+const char* saucerKernelName() {
+    return "sse2";
+}
+
+#else
+
+void moveSaucers(float* x, float* direction, const float* speed, const float* width,
+    std::size_t count, float deltaTime, float boundary) {
+    moveSaucersScalar(x, direction, speed, width, 0, count, deltaTime, boundary);
+}
+
+const char* saucerKernelName() {
+    return "scalar";
+}
+
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// The moving platforms, stored as one array per field so the per-tick movement runs
+// as a tight vectorised loop over plain floats instead of through individual objects.
+//
+// The arrays form a fixed-capacity ring buffer. New saucers appear as the bunny climbs,
+// so the oldest saucers are the ones it left far below and removal only ever pops the
+// front. A saucer is identified by its serial number (its position in spawn order);
+// slot(serial) gives its index into the arrays.
+class SaucerField {
+public:
+    std::vector<float> x;          // Left edge
+    std::vector<float> y;          // Top edge; saucers never move vertically
+    std::vector<float> width;
+    std::vector<float> height;
+    std::vector<float> speed;      // Pixels per second, always positive
+    std::vector<float> direction;  // -1 moving left, +1 moving right
+    std::vector<float> previousX;  // x at the start of the last tick, for render interpolation
+    std::vector<int> powerUp;      // Slot in GameWorld::powerUps, or -1 if none was spawned
+
+    int head;  // Serial of the oldest saucer
+    int tail;  // Serial the next spawned saucer will get
+
+    // Allocates all storage up front; capacity is rounded up to a power of two
+    explicit SaucerField(int capacity = 128);
+
+    int capacity() const {
+        return mask + 1;
+    }
+
+    int size() const {
+        return tail - head;
+    }
+
+    bool full() const {
+        return size() == capacity();
+    }
+
+    int slot(int serial) const {
+        return serial & mask;
+    }
+
+    void clear();
+
+    // Appends a saucer moving left and returns its serial. The field must not be full.
+    int add(float left, float top, float w, float h, float pixelsPerSecond = 30.f);
+
+    // Drops the oldest saucer
+    void popFront();
+
+    // Moves every saucer and bounces it off the edges of a world boundary pixels wide
+    void update(float deltaTime, float boundary);
+
+    void storePreviousPositions();
+
+private:
+    int mask;
+};
+
+// The movement kernel. x and direction are updated in place; the scalar version is the
+// reference the SIMD versions must match and handles whatever tail they leave over.
+void moveSaucersScalar(float* x, float* direction, const float* speed, const float* width,
+    std::size_t begin, std::size_t end, float deltaTime, float boundary);
+void moveSaucers(float* x, float* direction, const float* speed, const float* width,
+    std::size_t count, float deltaTime, float boundary);
+
+// Which instruction set moveSaucers was compiled for ("avx", "sse2" or "scalar")
+const char* saucerKernelName();
@@ -0,0 +1,507 @@
+// Command-line batch runner: plays many episodes of the headless GameWorld with a
+// simple bot and prints aggregate stats. No window, GPU or SFML needed.
+//
+//   cmake -S . -B build && cmake --build build
+//   build/bunny_sim --episodes 10000 --seed 42
+//   build/bunny_sim --bench-broadphase 10000
+//   build/bunny_sim --stress-saucers 50000
+//   build/bunny_sim --alloc-check 100000
+//   build/bunny_sim --soak 1800
+//   build/bunny_sim --check-geometry
+//   build/bunny_sim --record bot.bjr --seed 7 --max-ticks 72000
+//   build/bunny_sim --replay bot.bjr --repeat 20 --profile ticks.csv
+//   build/bunny_sim --episodes 100 --leaderboard scores
+#include "GameWorld.h"
+#include "Replay.h"
+#include "Leaderboard.h"
+#include "AllocCounter.h"
+#include "Bot.h"
+#include "BatchGeometry.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+
+// Times bunny-vs-coin queries against count coins spread up a tall column, once with the
+// plain loop over every coin and once through a SpatialGrid, and checks both agree
+int benchBroadphase(int count, std::uint64_t seed) {
+    RandomStream random(seed);
+    const float columnHeight = count * 10.f;
+    std::vector<Coin> coins;
+    for (int i = 0; i < count; ++i) {
+        float x = random.uniform(0, WORLD_WIDTH - 30);
+        coins.emplace_back(x, random.uniform(-columnHeight, WORLD_HEIGHT));
+    }
+    SpatialGrid grid(128.f, 4096);
+    for (int i = 0; i < count; ++i) {
+        grid.insert(i, coins[i].position.y, Coin::RADIUS * 2);
+    }
+
+    const int queries = 20000;
+    std::vector<Rect> probes;
+    for (int i = 0; i < queries; ++i) {
+        float x = random.uniform(0, WORLD_WIDTH - 30);
+        probes.push_back(Rect(x, random.uniform(-columnHeight, WORLD_HEIGHT), BUNNY_SIZE, BUNNY_SIZE));
+    }
+
+    long long bruteHits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Rect& probe : probes) {
+        for (const Coin& coin : coins) {
+            if (coin.checkCollision(probe)) {
+                bruteHits++;
+            }
+        }
+    }
+    double bruteSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long gridHits = 0;
+    std::vector<int> nearby;
+    start = std::chrono::steady_clock::now();
+    for (const Rect& probe : probes) {
+        grid.query(probe.top, probe.top + probe.height, nearby);
+        for (int index : nearby) {
+            if (coins[index].checkCollision(probe)) {
+                gridHits++;
+            }
+        }
+    }
+    double gridSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "entities:          " << count << "\n";
+    std::cout << "queries:           " << queries << "\n";
+    std::cout << "brute force ns/q:  " << bruteSeconds * 1e9 / queries << "\n";
+    std::cout << "grid ns/q:         " << gridSeconds * 1e9 / queries << "\n";
+    std::cout << "speedup:           " << (gridSeconds > 0 ? bruteSeconds / gridSeconds : 0.0) << "\n";
+    if (bruteHits != gridHits) {
+        std::cerr << "Mismatch: brute force found " << bruteHits << " hits, grid found " << gridHits << "\n";
+        return 1;
+    }
+    std::cout << "hits (both):       " << gridHits << "\n";
+    return 0;
+}
+
+// Moves count saucers for a few simulated minutes with the vectorised kernel and the
+// scalar reference, and checks both end up in exactly the same place
+int stressSaucers(int count, std::uint64_t seed) {
+    RandomStream random(seed);
+    SaucerField simd(count);
+    for (int i = 0; i < count; ++i) {
+        float x = random.uniform(-100, WORLD_WIDTH);
+        int saucer = simd.add(x, -10.f * i, 100, 20, random.uniform(10, 400));
+        if (i % 2) {
+            simd.direction[saucer] = 1;
+        }
+    }
+    SaucerField scalar = simd;
+
+    const int ticks = 120 * 60 * 3;
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        simd.update(deltaTime, WORLD_WIDTH);
+    }
+    double simdSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        moveSaucersScalar(scalar.x.data(), scalar.direction.data(), scalar.speed.data(), scalar.width.data(),
+            0, scalar.size(), deltaTime, WORLD_WIDTH);
+    }
+    double scalarSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double updates = double(ticks) * count;
+    std::cout << "saucers:           " << count << "\n";
+    std::cout << "kernel:            " << saucerKernelName() << "\n";
+    std::cout << "kernel ns/saucer:  " << simdSeconds * 1e9 / updates << "\n";
+    std::cout << "scalar ns/saucer:  " << scalarSeconds * 1e9 / updates << "\n";
+    if (simd.x != scalar.x || simd.direction != scalar.direction) {
+        std::cerr << "Mismatch between " << saucerKernelName() << " and scalar saucer kernels\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Plays the bot for a while to let every pool and scratch buffer reach its working size,
+// then counts heap allocations over ticks further ticks (restarting episodes as they end)
+int allocCheck(int ticks, std::uint64_t seed) {
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    GameWorld world(seed);
+    for (int tick = 0; tick < 10 * static_cast<int>(SIM_TICK_RATE); ++tick) {
+        world.step(botInput(world), deltaTime);
+    }
+
+    unsigned long long before = heapAllocations();
+    int resets = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        if (world.gameOver) {
+            world.reset();
+            resets++;
+        }
+        world.step(botInput(world), deltaTime);
+    }
+    unsigned long long allocations = heapAllocations() - before;
+
+    std::cout << "ticks:             " << ticks << "\n";
+    std::cout << "resets:            " << resets << "\n";
+    std::cout << "saucers spawned:   " << world.saucers.tail << "\n";
+    std::cout << "heap allocations:  " << allocations << "\n";
+    if (allocations != 0) {
+        std::cerr << "GameWorld::step allocated " << allocations << " times\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Lifts the bunny at a steady climb for seconds of game time, far higher than any real run
+// gets, and checks that everything the world keeps stays flat from the first minute to
+// the last: live entities, grid entries and heap allocations. The cost of a tick is only
+// reported, since wall-clock time also depends on whatever else the machine is doing.
+int soak(int seconds, std::uint64_t seed) {
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    const float climbSpeed = 1200; // Pixels per second, about twice a normal jump
+    const int ticksPerMinute = 60 * static_cast<int>(SIM_TICK_RATE);
+    GameWorld world(seed);
+
+    std::printf("minute   height   coins saucers power-ups  grid entries  allocations  us/tick\n");
+    int limitEntities = 0;
+    std::size_t limitGrid = 0;
+    double fastestTick = 0;
+    double lastTick = 0;
+    bool grew = false;
+    for (int minute = 0; minute * 60 < seconds; ++minute) {
+        int maxEntities = 0;
+        std::size_t maxGrid = 0;
+        unsigned long long before = heapAllocations();
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticksPerMinute; ++tick) {
+            world.bunny.velocity.y = -climbSpeed;
+            world.step(botInput(world), deltaTime);
+            maxEntities = std::max(maxEntities, world.coins.size() + world.saucers.size() + world.powerUps.size());
+            maxGrid = std::max(maxGrid, world.coinGrid.size() + world.saucerGrid.size());
+        }
+        double tickMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticksPerMinute;
+        unsigned long long allocations = heapAllocations() - before;
+        std::printf("%6d %8.0f %7d %7d %9d %13zu %12llu %8.2f\n", minute + 1, world.currentHeight(), world.coins.size(),
+            world.saucers.size(), world.powerUps.size(), maxGrid, allocations, tickMicros);
+
+        // The first minute is warm-up: pools and scratch buffers reach their working size
+        if (minute == 0) {
+            limitEntities = maxEntities;
+            limitGrid = maxGrid;
+            fastestTick = tickMicros;
+        }
+        else if (world.gameOver || maxEntities > limitEntities || maxGrid > limitGrid || allocations != 0) {
+            grew = true;
+        }
+        fastestTick = std::min(fastestTick, tickMicros);
+        lastTick = tickMicros;
+    }
+
+    if (grew) {
+        std::cerr << "World state grew after the first minute of climbing\n";
+        return 1;
+    }
+    if (lastTick > 2 * fastestTick) {
+        std::cerr << "Warning: ticks got slower while climbing: " << lastTick << " us against " << fastestTick << " us at best\n";
+    }
+    return 0;
+}
+
+// Twice the signed area of triangle abc; positive when it winds clockwise on screen (y down)
+static float winding(const BatchPoint& a, const BatchPoint& b, const BatchPoint& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+static bool near(const BatchPoint& point, float x, float y) {
+    return std::fabs(point.x - x) < 1e-3f && std::fabs(point.y - y) < 1e-3f;
+}
+
+// Checks the vertices SpriteBatch draws from: counts, positions, rotation, texture
+// coordinates and that every triangle winds the same way
+int checkGeometry() {
+    int failures = 0;
+    auto expect = [&](bool condition, const char* what) {
+        if (!condition) {
+            std::cerr << "Geometry check failed: " << what << "\n";
+            failures++;
+        }
+    };
+    auto sameWinding = [&](const std::vector<BatchVertex>& vertices) {
+        bool clockwise = true;
+        for (std::size_t i = 0; i + 2 < vertices.size(); i += 3) {
+            clockwise = clockwise && winding(vertices[i].position, vertices[i + 1].position, vertices[i + 2].position) > 0;
+        }
+        return clockwise;
+    };
+    const BatchColor red = { 255, 0, 0, 255 };
+    std::vector<BatchVertex> vertices;
+
+    // Plain textured quad: corners at position + size, texture rect mapped corner to corner
+    appendQuad(vertices, BatchPoint{ 100, 50 }, BatchPoint{ 30, 20 }, BatchPoint{ 0, 0 }, 0, red, BatchTextureRect{ 470, 390, 500, 310 });
+    expect(vertices.size() == 6, "a quad is two triangles");
+    expect(sameWinding(vertices), "quad triangles wind clockwise");
+    expect(near(vertices[0].position, 100, 50) && near(vertices[1].position, 130, 50)
+        && near(vertices[2].position, 130, 70) && near(vertices[5].position, 100, 70), "quad corners");
+    expect(near(vertices[0].texCoords, 470, 390) && near(vertices[2].texCoords, 970, 700)
+        && near(vertices[5].texCoords, 470, 700), "quad texture coordinates");
+    expect(vertices[4].color.r == 255 && vertices[4].color.a == 255, "quad colour");
+
+    // Rotating a quarter turn about its centre moves the top-left corner to the top-right
+    vertices.clear();
+    appendQuad(vertices, BatchPoint{ 100, 100 }, BatchPoint{ 30, 30 }, BatchPoint{ 15, 15 }, 90, red);
+    expect(near(vertices[0].position, 115, 85) && near(vertices[2].position, 85, 115), "quad rotation");
+    expect(sameWinding(vertices), "rotated quad triangles wind clockwise");
+
+    // Circle: one triangle per point, fanned from the centre of its bounding box
+    vertices.clear();
+    appendCircle(vertices, BatchPoint{ 0, 0 }, 15, red, 24);
+    expect(vertices.size() == 24 * 3, "a circle is one triangle per point");
+    expect(sameWinding(vertices), "circle triangles wind clockwise");
+    bool onRim = true;
+    for (std::size_t i = 0; i < vertices.size(); i += 3) {
+        onRim = onRim && near(vertices[i].position, 15, 15);
+        for (std::size_t corner = 1; corner < 3; ++corner) {
+            float dx = vertices[i + corner].position.x - 15;
+            float dy = vertices[i + corner].position.y - 15;
+            onRim = onRim && std::fabs(std::sqrt(dx * dx + dy * dy) - 15) < 1e-3f;
+        }
+    }
+    expect(onRim, "circle fans from its centre to its rim");
+
+    std::cout << "geometry checks:   " << (failures == 0 ? "passed" : "FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
+// Plays one bot episode and saves it as a replay, stats included, for use as a fixture
+int recordBot(const char* path, std::uint64_t seed, int maxTicks, float tickRate) {
+    GameWorld world(seed);
+    Replay replay;
+    replay.begin(seed, tickRate, maxTicks);
+    for (int tick = 0; tick < maxTicks && !world.gameOver; ++tick) {
+        InputState input = botInput(world);
+        replay.record(input);
+        world.step(input, 1.f / tickRate);
+    }
+    replay.finish(world);
+    if (!replay.save(path)) {
+        return 1;
+    }
+    std::cout << "recorded:          " << replay.inputs.size() << " ticks (" << replay.seconds() << " s)\n";
+    std::cout << "score:             " << replay.finalScore << "\n";
+    return 0;
+}
+
+// Plays a replay repeat times as fast as possible, timing it and checking every run ends
+// on the recorded stats
+int playReplay(const char* path, int repeat, const char* profilePath) {
+    Replay replay;
+    if (!replay.load(path)) {
+        return 1;
+    }
+    GameWorld world(replay.seed);
+    Profiler profiler;
+    if (profilePath) {
+        world.profiler = &profiler;
+    }
+    int mismatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < repeat; ++run) {
+        replay.play(world);
+        mismatches += replay.matches(world) ? 0 : 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double ticks = double(replay.inputs.size()) * repeat;
+    std::cout << "replay:            " << path << " (seed " << replay.seed << ", " << replay.seconds() << " s)\n";
+    std::cout << "runs:              " << repeat << "\n";
+    std::cout << "wall time (s):     " << seconds << "\n";
+    std::cout << "ns/tick:           " << (ticks > 0 ? seconds * 1e9 / ticks : 0.0) << "\n";
+    std::cout << "score:             " << world.stats.score << " (recorded " << replay.finalScore << ")\n";
+    std::cout << "saucers jumped:    " << world.stats.saucersJumped << " (recorded " << replay.finalSaucersJumped << ")\n";
+    if (profilePath) {
+        // Per-tick phase timings over the ticks still held in the profiler's ring
+        PhaseStats stats[PHASE_COUNT];
+        profiler.summarize(stats, static_cast<int>(profiler.currentFrame()) + 1);
+        std::printf("%-18s %8s %8s %8s %8s\n", "phase", "samples", "p50 ms", "p99 ms", "max ms");
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            if (stats[i].count > 0) {
+                std::printf("%-18s %8d %8.4f %8.4f %8.4f\n", phaseName(static_cast<ProfilePhase>(i)), stats[i].count, stats[i].p50, stats[i].p99, stats[i].max);
+            }
+        }
+        std::fflush(stdout);
+        if (!profiler.save(profilePath)) {
+            return 1;
+        }
+    }
+    if (mismatches > 0) {
+        std::cerr << mismatches << " of " << repeat << " runs diverged from the recording\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int episodes = 1000;
+    int maxTicks = 30 * static_cast<int>(SIM_TICK_RATE); // Thirty seconds of play
+    float tickRate = SIM_TICK_RATE;
+    std::uint64_t seed = 1;
+    int broadphaseCount = 0;
+    int stressCount = 0;
+    int allocTicks = 0;
+    int soakSeconds = 0;
+    bool geometry = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    int repeat = 1;
+    const char* profilePath = nullptr;
+    int lookahead = 0;
+    const char* leaderboardPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--episodes") == 0 && i + 1 < argc) {
+            episodes = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+            maxTicks = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--bench-broadphase") == 0 && i + 1 < argc) {
+            broadphaseCount = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--stress-saucers") == 0 && i + 1 < argc) {
+            stressCount = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--alloc-check") == 0 && i + 1 < argc) {
+            allocTicks = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+            soakSeconds = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--check-geometry") == 0) {
+            geometry = true;
+        }
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--lookahead") == 0 && i + 1 < argc) {
+            lookahead = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--leaderboard") == 0 && i + 1 < argc) {
+            leaderboardPath = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--episodes N] [--max-ticks N] [--lookahead TICKS] [--tick-rate HZ] [--seed N] [--leaderboard PATH] [--bench-broadphase N] [--stress-saucers N] [--alloc-check TICKS] [--soak SECONDS] [--check-geometry]"
+                " [--record FILE] [--replay FILE [--repeat N] [--profile FILE]]\n";
+            return 1;
+        }
+    }
+
+    if (broadphaseCount > 0) {
+        return benchBroadphase(broadphaseCount, seed);
+    }
+    if (stressCount > 0) {
+        return stressSaucers(stressCount, seed);
+    }
+    if (allocTicks > 0) {
+        return allocCheck(allocTicks, seed);
+    }
+    if (soakSeconds > 0) {
+        return soak(soakSeconds, seed);
+    }
+    if (geometry) {
+        return checkGeometry();
+    }
+    if (recordPath) {
+        return recordBot(recordPath, seed, maxTicks, tickRate);
+    }
+    if (replayPath) {
+        return playReplay(replayPath, repeat, profilePath);
+    }
+
+    const float deltaTime = 1.f / tickRate;
+
+    // --leaderboard adds every episode to a persistent board, as the game does with its runs
+    Leaderboard leaderboard;
+    if (leaderboardPath) {
+        auto openStart = std::chrono::steady_clock::now();
+        if (!leaderboard.open(leaderboardPath)) {
+            return 1;
+        }
+        double openSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - openStart).count();
+        std::cout << "leaderboard:      " << leaderboard.runs() << " runs, opened in " << openSeconds * 1e3 << " ms\n";
+        leaderboard.start();
+    }
+
+    // --lookahead switches the episodes to the bot that tries each steering choice that
+    // many ticks ahead, restoring a snapshot between tries
+    WorldSnapshot snapshot;
+    GameWorld world(seed);
+    long long totalTicks = 0;
+    long long totalScore = 0;
+    int bestScore = 0;
+    int gameOvers = 0;
+    double totalHeight = 0;
+    float bestHeight = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int episode = 0; episode < episodes; ++episode) {
+        world.reset(seed + episode);
+        float peakHeight = world.currentHeight();
+        int tick = 0;
+        for (; tick < maxTicks && !world.gameOver; ++tick) {
+            InputState input = lookahead > 0 ? lookaheadBotInput(world, snapshot, deltaTime, lookahead) : botInput(world);
+            world.step(input, deltaTime);
+            peakHeight = std::max(peakHeight, world.currentHeight());
+        }
+        totalTicks += tick;
+        totalScore += world.stats.score;
+        bestScore = std::max(bestScore, world.stats.score);
+        gameOvers += world.gameOver ? 1 : 0;
+        totalHeight += peakHeight;
+        bestHeight = std::max(bestHeight, peakHeight);
+        if (leaderboardPath && !leaderboard.submit(finishedRun(world, seed + episode))) {
+            leaderboard.stop(); // The queue is full: let the writer catch up inline
+            leaderboard.submit(finishedRun(world, seed + episode));
+            leaderboard.start();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "episodes:         " << episodes << "\n";
+    std::cout << "ticks:            " << totalTicks << "\n";
+    std::cout << "game overs:       " << gameOvers << "\n";
+    std::cout << "mean score:       " << (episodes ? double(totalScore) / episodes : 0.0) << "\n";
+    std::cout << "best score:       " << bestScore << "\n";
+    std::cout << "mean peak height: " << (episodes ? totalHeight / episodes : 0.0) << "\n";
+    std::cout << "best peak height: " << bestHeight << "\n";
+    std::cout << "wall time (s):    " << seconds << "\n";
+    std::cout << "episodes/s:       " << (seconds > 0 ? episodes / seconds : 0.0) << "\n";
+    std::cout << "ticks/s:          " << (seconds > 0 ? totalTicks / seconds : 0.0) << "\n";
+    if (leaderboardPath) {
+        leaderboard.stop();
+        RunRecord best[5];
+        int count = leaderboard.top(best, 5);
+        std::cout << "leaderboard runs: " << leaderboard.runs() << "\n";
+        for (int i = 0; i < count; ++i) {
+            std::printf("  #%d  %6d  height %8.1f  seed %llu\n", i + 1, best[i].score, best[i].height, static_cast<unsigned long long>(best[i].seed));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellHeight, int bucketCount, int bucketReserve)
+    : cellHeight(cellHeight), buckets(bucketCount), bucketMask(bucketCount - 1), tallest(0), count(0) {
+    for (auto& bucket : buckets) {
+        bucket.reserve(bucketReserve);
+    }
+}
+
+void SpatialGrid::clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    tallest = 0;
+    count = 0;
+}
+
+void SpatialGrid::insert(int id, float top, float height) {
+    buckets[rowOf(top) & bucketMask].push_back(Entry{ id, top, top + height });
+    tallest = std::max(tallest, height);
+    count++;
+}
+
+void SpatialGrid::remove(int id, float top) {
+    std::vector<Entry>& bucket = buckets[rowOf(top) & bucketMask];
+    for (std::size_t i = 0; i < bucket.size(); ++i) {
+        if (bucket[i].id == id) {
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            count--;
+            return;
+        }
+    }
+}
+
+void SpatialGrid::query(float top, float bottom, std::vector<int>& out) const {
+    out.clear();
+
+    // An entry starting up to `tallest` above the range can still reach into it
+    int fromRow = rowOf(top - tallest);
+    int toRow = rowOf(bottom);
+    if (toRow - fromRow + 1 >= static_cast<int>(buckets.size())) {
+        for (const auto& bucket : buckets) {
+            collect(bucket, top, bottom, out);
+        }
+    }
+    else {
+        for (int row = fromRow; row <= toRow; ++row) {
+            collect(buckets[row & bucketMask], top, bottom, out);
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
+
+int SpatialGrid::rowOf(float y) const {
+    return static_cast<int>(std::floor(y / cellHeight));
+}
+
+void SpatialGrid::collect(const std::vector<Entry>& bucket, float top, float bottom, std::vector<int>& out) const {
+    for (const auto& entry : bucket) {
+        if (entry.top < bottom && entry.bottom > top) {
+            out.push_back(entry.id);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+// Broadphase for the vertical level: entries are bucketed by the band of world Y they
+// cover, so a query only looks at the few rows around the bunny instead of every entity.
+// Nothing in the game moves vertically except the bunny, so an entry stays valid from
+// insert until remove. Rows hash into a fixed ring of buckets, so the grid never grows
+// however high the level goes; entries from far-away rows sharing a bucket are filtered out.
+class SpatialGrid {
+public:
+    // bucketCount must be a power of two; each bucket reserves room for bucketReserve
+    // entries up front so steady-state inserts do not allocate
+    explicit SpatialGrid(float cellHeight = 128.f, int bucketCount = 256, int bucketReserve = 8);
+
+    void clear();
+
+    // Adds id covering world Y from top to top + height
+    void insert(int id, float top, float height);
+
+    // Removes id, which must have been inserted with the same top
+    void remove(int id, float top);
+
+    // Replaces out with the ids whose band overlaps (top, bottom), in ascending order
+    void query(float top, float bottom, std::vector<int>& out) const;
+
+    std::size_t size() const {
+        return count;
+    }
+
+private:
+    struct Entry {
+        int id;
+        float top;
+        float bottom;
+    };
+
+    float cellHeight;
+    std::vector<std::vector<Entry>> buckets;
+    int bucketMask;
+    float tallest;  // Tallest entry, so queries know how far up to look
+    std::size_t count;
+
+    int rowOf(float y) const;
+    void collect(const std::vector<Entry>& bucket, float top, float bottom, std::vector<int>& out) const;
+};
@@ -0,0 +1,54 @@
+#include "SpriteBatch.h"
+
+static BatchPoint point(sf::Vector2f vector) {
+    return BatchPoint{ vector.x, vector.y };
+}
+
+static BatchColor color(sf::Color color) {
+    return BatchColor{ color.r, color.g, color.b, color.a };
+}
+
+void SpriteBatch::clear() {
+    for (auto& batch : batches) {
+        batch.vertices.clear();
+    }
+}
+
+void SpriteBatch::addQuad(const sf::Texture* texture, sf::Vector2f position, sf::Vector2f size,
+    sf::Vector2f origin, float rotation, sf::Color fill, sf::FloatRect textureRect) {
+    appendQuad(batchFor(texture), point(position), point(size), point(origin), rotation, color(fill),
+        BatchTextureRect{ textureRect.left, textureRect.top, textureRect.width, textureRect.height });
+}
+
+void SpriteBatch::addCircle(sf::Vector2f position, float radius, sf::Color fill) {
+    appendCircle(batchFor(nullptr), point(position), radius, color(fill));
+}
+
+void SpriteBatch::drawTo(sf::RenderTarget& target) const {
+    for (const auto& batch : batches) {
+        if (!batch.vertices.empty()) {
+            target.draw(reinterpret_cast<const sf::Vertex*>(batch.vertices.data()), batch.vertices.size(),
+                sf::Triangles, sf::RenderStates(batch.texture));
+        }
+    }
+}
+
+std::size_t SpriteBatch::drawCalls() const {
+    std::size_t calls = 0;
+    for (const auto& batch : batches) {
+        if (!batch.vertices.empty()) {
+            calls++;
+        }
+    }
+    return calls;
+}
+
+std::vector<BatchVertex>& SpriteBatch::batchFor(const sf::Texture* texture) {
+    for (auto& batch : batches) {
+        if (batch.texture == texture) {
+            return batch.vertices;
+        }
+    }
+    batches.push_back(Batch{ texture, std::vector<BatchVertex>() });
+    return batches.back().vertices;
+}
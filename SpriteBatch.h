@@ -0,0 +1,36 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+#include "BatchGeometry.h"
+
+// Collects quads and circles per texture over a frame and submits each texture's
+// vertices with a single draw call. Batches are drawn in the order they were first used;
+// the vertices themselves come from BatchGeometry.
+class SpriteBatch {
+public:
+    struct Batch {
+        const sf::Texture* texture;  // nullptr for plain coloured geometry
+        std::vector<BatchVertex> vertices; // Triangles
+    };
+
+    std::vector<Batch> batches;
+
+    // Empties every batch but keeps the vertex storage for the next frame
+    void clear();
+
+    void addQuad(const sf::Texture* texture, sf::Vector2f position, sf::Vector2f size,
+        sf::Vector2f origin, float rotation, sf::Color color, sf::FloatRect textureRect = sf::FloatRect());
+    void addCircle(sf::Vector2f position, float radius, sf::Color color);
+
+    void drawTo(sf::RenderTarget& target) const;
+
+    // Number of draw calls the next drawTo will issue
+    std::size_t drawCalls() const;
+
+private:
+    std::vector<BatchVertex>& batchFor(const sf::Texture* texture);
+};
+
+static_assert(sizeof(BatchVertex) == sizeof(sf::Vertex) && offsetof(BatchVertex, color) == offsetof(sf::Vertex, color)
+    && offsetof(BatchVertex, texCoords) == offsetof(sf::Vertex, texCoords), "BatchVertex must match sf::Vertex");
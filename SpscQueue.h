@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer single-consumer queue. One thread pushes, one thread pops, and
+// neither ever blocks or allocates: each side only writes its own index.
+template <typename T, int Capacity>
+class SpscQueue {
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    bool push(const T& item) {
+        std::size_t back = tail.load(std::memory_order_relaxed);
+        if (back - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[back % Capacity] = item;
+        tail.store(back + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Oldest item, or null if the queue is empty. Consumer only.
+    const T* front() const {
+        std::size_t front = head.load(std::memory_order_relaxed);
+        if (front == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items[front % Capacity];
+    }
+
+    void pop() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool full() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) == Capacity;
+    }
+
+private:
+    std::array<T, Capacity> items;
+    std::atomic<std::size_t> head;  // Written by the consumer
+    std::atomic<std::size_t> tail;  // Written by the producer
+};
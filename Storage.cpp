@@ -0,0 +1,250 @@
+#include "Storage.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), file(-1), mapping(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::openRead(const std::string& path) {
+    return map(path, 0, false);
+}
+
+bool MappedFile::openWrite(const std::string& path, std::size_t size) {
+    return map(path, size, true);
+}
+
+#ifdef _WIN32
+
+bool MappedFile::map(const std::string& path, std::size_t size, bool writable) {
+    close();
+    HANDLE handle = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+        writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        CloseHandle(handle);
+        return false;
+    }
+    std::size_t mapped = static_cast<std::size_t>(fileSize.QuadPart);
+    if (writable && mapped < size) {
+        mapped = size; // The mapping grows the file, zero-filled
+    }
+    if (mapped == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE view = CreateFileMappingA(handle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+        static_cast<DWORD>(static_cast<std::uint64_t>(mapped) >> 32), static_cast<DWORD>(mapped), nullptr);
+    if (!view) {
+        CloseHandle(handle);
+        return false;
+    }
+    void* address = MapViewOfFile(view, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, mapped);
+    if (!address) {
+        CloseHandle(view);
+        CloseHandle(handle);
+        return false;
+    }
+    bytes = static_cast<unsigned char*>(address);
+    length = mapped;
+    file = reinterpret_cast<std::intptr_t>(handle);
+    mapping = reinterpret_cast<std::intptr_t>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        UnmapViewOfFile(bytes);
+        CloseHandle(reinterpret_cast<HANDLE>(mapping));
+        CloseHandle(reinterpret_cast<HANDLE>(file));
+    }
+    bytes = nullptr;
+    length = 0;
+    file = -1;
+    mapping = 0;
+}
+
+bool MappedFile::flush() {
+    return bytes && FlushViewOfFile(bytes, length) && FlushFileBuffers(reinterpret_cast<HANDLE>(file));
+}
+
+#else
+
+bool MappedFile::map(const std::string& path, std::size_t size, bool writable) {
+    close();
+    int handle = ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (handle < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(handle, &info) != 0) {
+        ::close(handle);
+        return false;
+    }
+    std::size_t mapped = static_cast<std::size_t>(info.st_size);
+    if (writable && mapped < size) {
+        if (ftruncate(handle, static_cast<off_t>(size)) != 0) { // Grows the file, zero-filled
+            ::close(handle);
+            return false;
+        }
+        mapped = size;
+    }
+    if (mapped == 0) {
+        ::close(handle);
+        return false;
+    }
+    void* address = mmap(nullptr, mapped, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, handle, 0);
+    if (address == MAP_FAILED) {
+        ::close(handle);
+        return false;
+    }
+    bytes = static_cast<unsigned char*>(address);
+    length = mapped;
+    file = handle;
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        munmap(bytes, length);
+        ::close(static_cast<int>(file));
+    }
+    bytes = nullptr;
+    length = 0;
+    file = -1;
+}
+
+bool MappedFile::flush() {
+    return bytes && msync(bytes, length, MS_SYNC) == 0;
+}
+
+#endif
+
+AppendFile::AppendFile() : file(-1), length(0) {}
+
+AppendFile::~AppendFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool AppendFile::open(const std::string& path) {
+    close();
+    file = _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (file < 0) {
+        return false;
+    }
+    length = static_cast<std::uint64_t>(_lseeki64(file, 0, SEEK_END));
+    return true;
+}
+
+void AppendFile::close() {
+    if (file >= 0) {
+        _close(file);
+    }
+    file = -1;
+    length = 0;
+}
+
+bool AppendFile::append(const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    if (file < 0 || _lseeki64(file, static_cast<__int64>(length), SEEK_SET) < 0) {
+        return false;
+    }
+    for (std::size_t written = 0; written < size;) {
+        int result = _write(file, bytes + written, static_cast<unsigned int>(size - written));
+        if (result <= 0) {
+            return false;
+        }
+        written += result;
+    }
+    length += size;
+    return _commit(file) == 0;
+}
+
+bool AppendFile::read(std::uint64_t offset, void* data, std::size_t size) const {
+    if (file < 0 || offset + size > length || _lseeki64(file, static_cast<__int64>(offset), SEEK_SET) < 0) {
+        return false;
+    }
+    return _read(file, data, static_cast<unsigned int>(size)) == static_cast<int>(size);
+}
+
+bool AppendFile::truncate(std::uint64_t size) {
+    if (file < 0 || _chsize_s(file, static_cast<__int64>(size)) != 0) {
+        return false;
+    }
+    length = size;
+    return _commit(file) == 0;
+}
+
+#else
+
+bool AppendFile::open(const std::string& path) {
+    close();
+    file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<std::uint64_t>(info.st_size);
+    return true;
+}
+
+void AppendFile::close() {
+    if (file >= 0) {
+        ::close(file);
+    }
+    file = -1;
+    length = 0;
+}
+
+bool AppendFile::append(const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    for (std::size_t written = 0; written < size;) {
+        ssize_t result = pwrite(file, bytes + written, size - written, static_cast<off_t>(length + written));
+        if (result <= 0) {
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    length += size;
+    return fsync(file) == 0;
+}
+
+bool AppendFile::read(std::uint64_t offset, void* data, std::size_t size) const {
+    if (file < 0 || offset + size > length) {
+        return false;
+    }
+    return pread(file, data, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size);
+}
+
+bool AppendFile::truncate(std::uint64_t size) {
+    if (file < 0 || ftruncate(file, static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+    length = size;
+    return fsync(file) == 0;
+}
+
+#endif
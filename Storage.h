@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Thin layer over the two ways the game keeps data on disk: memory-mapped files, read
+// in place without parsing, and append-only files whose writes are flushed to the device
+// before they count. Both hide the Windows and POSIX calls behind the same few methods.
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps an existing file for reading
+    bool openRead(const std::string& path);
+
+    // Maps path for reading and writing, creating it (zero-filled) or growing it to size bytes
+    bool openWrite(const std::string& path, std::size_t size);
+
+    void close();
+
+    // Writes dirty pages back and waits until the device has them
+    bool flush();
+
+    bool isOpen() const {
+        return bytes != nullptr;
+    }
+
+    unsigned char* data() {
+        return bytes;
+    }
+
+    const unsigned char* data() const {
+        return bytes;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+private:
+    unsigned char* bytes;
+    std::size_t length;
+    std::intptr_t file;     // File descriptor, or HANDLE on Windows
+    std::intptr_t mapping;  // File mapping HANDLE on Windows, unused elsewhere
+
+    bool map(const std::string& path, std::size_t size, bool writable);
+};
+
+class AppendFile {
+public:
+    AppendFile();
+    ~AppendFile();
+
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    // Opens path for appending, creating it if needed
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const {
+        return file >= 0;
+    }
+
+    std::uint64_t size() const {
+        return length;
+    }
+
+    // Appends the bytes and returns once they are on the device
+    bool append(const void* data, std::size_t size);
+
+    // Reads size bytes at offset, which must lie inside the file
+    bool read(std::uint64_t offset, void* data, std::size_t size) const;
+
+    // Cuts the file back to size bytes, e.g. to drop a record torn by a crash
+    bool truncate(std::uint64_t size);
+
+private:
+    int file;
+    std::uint64_t length;
+};
@@ -0,0 +1,201 @@
+// Parameter sweep: plays the bot over every combination of the given GameConfig values
+// times a range of seeds, spread over all cores, and prints survival height and score
+// statistics per configuration.
+//
+//   build/bunny_sweep --gravity 880,980,1080 --jump 550,600,650 --seeds 200
+//   build/bunny_sweep --coin-interval 5,10 --power-up-duration 3,5,8 --csv sweep.csv
+//
+// Every list flag takes comma-separated values; flags left out keep the shipped default.
+#include "GameWorld.h"
+#include "Bot.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct RunResult {
+    float peakHeight;
+    int score;
+    bool gameOver;
+};
+
+struct SweepAxis {
+    const char* flag;
+    const char* column;
+    float GameConfig::*field;
+    std::vector<float> values;
+};
+
+std::vector<float> parseList(const char* text) {
+    std::vector<float> values;
+    for (const char* cursor = text; *cursor;) {
+        char* end = nullptr;
+        values.push_back(std::strtof(cursor, &end));
+        if (end == cursor) {
+            return std::vector<float>();
+        }
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+RunResult runEpisode(const GameConfig& config, std::uint64_t seed, int maxTicks, float deltaTime) {
+    GameWorld world(seed, config);
+    float peakHeight = world.currentHeight();
+    for (int tick = 0; tick < maxTicks && !world.gameOver; ++tick) {
+        world.step(botInput(world), deltaTime);
+        peakHeight = std::max(peakHeight, world.currentHeight());
+    }
+    return RunResult{ peakHeight, world.stats.score, world.gameOver };
+}
+
+// Value at fraction of the way through sorted values
+float percentile(const std::vector<float>& sorted, double fraction) {
+    return sorted[static_cast<std::size_t>(fraction * (sorted.size() - 1))];
+}
+
+int main(int argc, char** argv) {
+    GameConfig defaults;
+    SweepAxis axes[] = {
+        { "--gravity", "gravity", &GameConfig::gravity, std::vector<float>() },
+        { "--jump", "jump", &GameConfig::jumpVelocity, std::vector<float>() },
+        { "--super-jump", "super", &GameConfig::superJumpVelocity, std::vector<float>() },
+        { "--speed", "speed", &GameConfig::baseSpeed, std::vector<float>() },
+        { "--power-up-duration", "pu_dur", &GameConfig::powerUpDuration, std::vector<float>() },
+        { "--coin-interval", "coin_int", &GameConfig::coinSpawnInterval, std::vector<float>() },
+        { "--power-up-interval", "pu_int", &GameConfig::powerUpSpawnInterval, std::vector<float>() },
+    };
+
+    int seeds = 100;
+    std::uint64_t firstSeed = 1;
+    int maxTicks = 60 * static_cast<int>(SIM_TICK_RATE); // One minute of play
+    int threads = 0;
+    const char* csvPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        bool matched = false;
+        for (SweepAxis& axis : axes) {
+            if (std::strcmp(argv[i], axis.flag) == 0 && i + 1 < argc) {
+                axis.values = parseList(argv[++i]);
+                matched = !axis.values.empty();
+            }
+        }
+        if (matched) {
+            continue;
+        }
+        if (std::strcmp(argv[i], "--seeds") == 0 && i + 1 < argc) {
+            seeds = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--first-seed") == 0 && i + 1 < argc) {
+            firstSeed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+            maxTicks = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        }
+        else {
+            std::fprintf(stderr, "Usage: %s [--gravity LIST] [--jump LIST] [--super-jump LIST] [--speed LIST]"
+                " [--power-up-duration LIST] [--coin-interval LIST] [--power-up-interval LIST]"
+                " [--seeds N] [--first-seed N] [--max-ticks N] [--threads N] [--csv FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (seeds <= 0) {
+        seeds = 1;
+    }
+
+    // Every combination of the axis values, first axis varying slowest
+    for (SweepAxis& axis : axes) {
+        if (axis.values.empty()) {
+            axis.values.push_back(defaults.*axis.field);
+        }
+    }
+    std::vector<GameConfig> configs(1, defaults);
+    for (const SweepAxis& axis : axes) {
+        std::vector<GameConfig> expanded;
+        for (const GameConfig& config : configs) {
+            for (float value : axis.values) {
+                expanded.push_back(config);
+                expanded.back().*axis.field = value;
+            }
+        }
+        configs.swap(expanded);
+    }
+
+    // One task per run; each writes only its own slot, so results need no locking
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    std::vector<RunResult> results(configs.size() * seeds);
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    for (std::size_t config = 0; config < configs.size(); ++config) {
+        for (int seed = 0; seed < seeds; ++seed) {
+            RunResult* result = &results[config * seeds + seed];
+            const GameConfig* settings = &configs[config];
+            pool.submit([=]() {
+                *result = runEpisode(*settings, firstSeed + seed, maxTicks, deltaTime);
+            });
+        }
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE* csv = csvPath ? std::fopen(csvPath, "w") : nullptr;
+    if (csvPath && !csv) {
+        std::fprintf(stderr, "Failed to write %s\n", csvPath);
+        return 1;
+    }
+    if (csv) {
+        for (const SweepAxis& axis : axes) {
+            std::fprintf(csv, "%s,", axis.column);
+        }
+        std::fprintf(csv, "runs,game_overs,mean_height,p10_height,p50_height,p90_height,mean_score\n");
+    }
+    for (const SweepAxis& axis : axes) {
+        std::printf("%9s", axis.column);
+    }
+    std::printf(" %6s %6s %9s %9s %9s %9s %9s\n", "runs", "falls", "height", "p10", "p50", "p90", "score");
+
+    std::vector<float> heights(seeds);
+    for (std::size_t config = 0; config < configs.size(); ++config) {
+        double totalHeight = 0;
+        double totalScore = 0;
+        int gameOvers = 0;
+        for (int seed = 0; seed < seeds; ++seed) {
+            const RunResult& result = results[config * seeds + seed];
+            heights[seed] = result.peakHeight;
+            totalHeight += result.peakHeight;
+            totalScore += result.score;
+            gameOvers += result.gameOver ? 1 : 0;
+        }
+        std::sort(heights.begin(), heights.end());
+
+        for (const SweepAxis& axis : axes) {
+            std::printf("%9g", configs[config].*axis.field);
+        }
+        std::printf(" %6d %6d %9.1f %9.1f %9.1f %9.1f %9.1f\n", seeds, gameOvers, totalHeight / seeds,
+            percentile(heights, 0.1), percentile(heights, 0.5), percentile(heights, 0.9), totalScore / seeds);
+        if (csv) {
+            for (const SweepAxis& axis : axes) {
+                std::fprintf(csv, "%g,", configs[config].*axis.field);
+            }
+            std::fprintf(csv, "%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f\n", seeds, gameOvers, totalHeight / seeds,
+                percentile(heights, 0.1), percentile(heights, 0.5), percentile(heights, 0.9), totalScore / seeds);
+        }
+    }
+    if (csv) {
+        std::fclose(csv);
+    }
+
+    std::printf("%d runs on %d threads in %.2f s (%.0f runs/s, %llu steals)\n", static_cast<int>(results.size()),
+        pool.size(), seconds, seconds > 0 ? results.size() / seconds : 0.0, static_cast<unsigned long long>(pool.steals));
+    return 0;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each. Submitted tasks are dealt out
+// round-robin; a worker takes from the back of its own deque and, once that is empty,
+// steals from the front of the others. Tasks that finish early (a bot falling off in
+// the first second) therefore never leave a core idle while another has a backlog.
+class ThreadPool {
+public:
+    std::atomic<unsigned long long> steals;  // Tasks run by a worker other than the one they were dealt to
+
+    explicit ThreadPool(int threadCount = 0) : steals(0), queued(0), pending(0), nextWorker(0), stopping(false) {
+        if (threadCount <= 0) {
+            threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        }
+        if (threadCount <= 0) {
+            threadCount = 1;
+        }
+        for (int i = 0; i < threadCount; ++i) {
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(&ThreadPool::run, this, i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const {
+        return static_cast<int>(workers.size());
+    }
+
+    void submit(std::function<void()> task) {
+        pending++;
+        Worker& worker = *workers[nextWorker++ % workers.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        queued++;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    // Blocks until every submitted task has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        idle.wait(lock, [this]() { return pending == 0; });
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<int> queued;         // Tasks sitting in a deque
+    std::atomic<int> pending;        // Tasks submitted and not yet finished
+    std::atomic<unsigned> nextWorker;
+    bool stopping;                   // Guarded by sleepMutex
+    std::mutex sleepMutex;
+    std::condition_variable wake;    // Signalled when work arrives or the pool shuts down
+    std::condition_variable idle;    // Signalled when pending drops to zero
+
+    bool take(int index, std::function<void()>& task) {
+        // Own deque first, newest task first
+        {
+            Worker& own = *workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        // Then steal the oldest task of the next worker that has one
+        for (std::size_t offset = 1; offset < workers.size(); ++offset) {
+            Worker& victim = *workers[(index + offset) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(int index) {
+        for (;;) {
+            std::function<void()> task;
+            if (take(index, task)) {
+                queued--;
+                task();
+                if (--pending == 0) {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    idle.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() { return stopping || queued > 0; });
+            if (stopping && queued == 0) {
+                return;
+            }
+        }
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstdint>
+
+// Hierarchical timer wheel counting simulation ticks. Each timer has a fixed id below
+// Capacity and is either pending or not; scheduling a pending timer moves it. Timers
+// sit in one of LEVELS wheels of SLOTS buckets, the coarser wheels holding the ones due
+// further out and moving them down a level as their time comes closer, so scheduling,
+// cancelling and each tick's expiry are all constant time however many timers are
+// pending, and a tick with nothing due touches a single empty bucket.
+//
+// Everything is plain arrays of ints, so a wheel is trivially copyable and a snapshot of
+// a world carries its timers with it.
+template <int Capacity>
+class TimerWheel {
+public:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+    static const std::uint32_t MAX_DELAY = (1u << (SLOT_BITS * LEVELS)) - 1;  // About 78 hours at 60 Hz
+
+    TimerWheel() {
+        clear();
+    }
+
+    // Cancels every timer and winds the clock back to tick 0
+    void clear() {
+        tick = 0;
+        for (int i = 0; i < LEVELS * SLOTS; ++i) {
+            heads[i] = -1;
+        }
+        for (int id = 0; id < Capacity; ++id) {
+            bucket[id] = -1;
+        }
+    }
+
+    std::uint32_t now() const {
+        return tick;
+    }
+
+    // Makes timer id fire delay ticks from now (at least one, at most MAX_DELAY)
+    void schedule(int id, std::uint32_t delay) {
+        cancel(id);
+        expiry[id] = tick + (delay < 1 ? 1 : delay > MAX_DELAY ? MAX_DELAY : delay);
+        link(id);
+    }
+
+    void cancel(int id) {
+        if (bucket[id] < 0) {
+            bucket[id] = -1; // Also stops a timer due this tick that has not fired yet
+            return;
+        }
+        if (previous[id] >= 0) {
+            next[previous[id]] = next[id];
+        }
+        else {
+            heads[bucket[id]] = next[id];
+        }
+        if (next[id] >= 0) {
+            previous[next[id]] = previous[id];
+        }
+        bucket[id] = -1;
+    }
+
+    bool pending(int id) const {
+        return bucket[id] >= 0;
+    }
+
+    // Ticks until a pending timer fires
+    std::uint32_t remaining(int id) const {
+        return expiry[id] - tick;
+    }
+
+    // Moves the clock on one tick and calls fire(id) for every timer due on it. Timers due
+    // on the same tick fire in a fixed order, so a run replays exactly; fire may schedule
+    // or cancel any timer, including the one firing.
+    template <typename Fire>
+    void advance(Fire fire) {
+        tick++;
+
+        // When a wheel comes round, the bucket of the next wheel up that is now current
+        // is spread over the finer wheels below it
+        for (int level = 1; level < LEVELS; ++level) {
+            if ((tick & ((1u << (SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            int index = level * SLOTS + ((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+            int id = heads[index];
+            heads[index] = -1;
+            while (id >= 0) {
+                int following = next[id];
+                link(id);
+                id = following;
+            }
+        }
+
+        // Take the due timers off the wheel before firing any, so fire can reschedule freely
+        int due[Capacity];
+        int count = 0;
+        int index = tick & (SLOTS - 1);
+        for (int id = heads[index]; id >= 0; id = next[id]) {
+            due[count++] = id;
+            bucket[id] = DUE;
+        }
+        heads[index] = -1;
+        for (int i = 0; i < count; ++i) {
+            if (bucket[due[i]] == DUE) {
+                bucket[due[i]] = -1;
+                fire(due[i]);
+            }
+        }
+    }
+
+private:
+    static const int DUE = -2;  // bucket[] of a timer taken off the wheel to fire this tick
+
+    std::uint32_t tick;
+    int heads[LEVELS * SLOTS];  // First timer in each bucket, -1 when empty
+    int next[Capacity];
+    int previous[Capacity];
+    int bucket[Capacity];       // Bucket the timer is in, negative when it is not pending
+    std::uint32_t expiry[Capacity];
+
+    // Files a timer on the finest wheel whose span still reaches its expiry
+    void link(int id) {
+        std::uint32_t delta = expiry[id] - tick;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1u << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        int index = level * SLOTS + ((expiry[id] >> (SLOT_BITS * level)) & (SLOTS - 1));
+        bucket[id] = index;
+        previous[id] = -1;
+        next[id] = heads[index];
+        if (next[id] >= 0) {
+            previous[next[id]] = id;
+        }
+        heads[index] = id;
+    }
+};
@@ -0,0 +1,254 @@
+// Replay verification service: re-simulates submitted runs on every core and accepts or
+// rejects the score each one claims. Until there is a network front end, submissions
+// arrive as replay files dropped into an inbox directory.
+//
+//   build/bunny_verify run1.bjr run2.bjr
+//   build/bunny_verify --inbox drop --threads 8
+//   build/bunny_verify --inbox drop --once
+//   build/bunny_verify --bench 5000
+//
+// In inbox mode each *.bjr file is verified, moved into drop/accepted or drop/rejected and
+// given a line in drop/verdicts.txt. Submitters should write a file under another name and
+// rename it to .bjr when it is complete, so a half-written replay is never picked up.
+#include "ReplayVerifier.h"
+#include "Bot.h"
+#include "Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Reads a submitted replay. Anything longer than the verifier would play is refused before
+// it is allocated, and running out of memory anyway is treated as one more malformed file
+// rather than taking the service down.
+bool loadSubmission(Replay& replay, const std::string& path) {
+    try {
+        return replay.load(path, MAX_VERIFY_TICKS);
+    }
+    catch (const std::bad_alloc&) {
+        std::fprintf(stderr, "Out of memory loading %s\n", path.c_str());
+        return false;
+    }
+}
+
+// Verifies the files named on the command line; fails unless every one is accepted
+int verifyFiles(const std::vector<std::string>& paths, int threads, int queue) {
+    ReplayVerifier verifier(threads, queue);
+    int rejected = 0;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        Replay replay;
+        if (!loadSubmission(replay, paths[i])) {
+            std::printf("%-40s %-9s\n", paths[i].c_str(), verifyStatusName(VERIFY_MALFORMED));
+            rejected++;
+            continue;
+        }
+        verifier.submit(i, std::move(replay));
+    }
+    verifier.wait();
+
+    VerifyResult result;
+    while (verifier.poll(result)) {
+        std::printf("%-40s %-9s claimed %6d scored %6d in %.2f ms\n", paths[result.id].c_str(), verifyStatusName(result.status),
+            result.claimedScore, result.score, result.seconds * 1e3);
+        rejected += result.status == VERIFY_ACCEPTED ? 0 : 1;
+    }
+    return rejected == 0 ? 0 : 1;
+}
+
+// Watches inbox for dropped replays until interrupted, or until it is empty with once
+int serveInbox(const fs::path& inbox, int threads, int queue, bool once, Logger& logger) {
+    std::error_code error;
+    fs::create_directories(inbox / "accepted", error);
+    fs::create_directories(inbox / "rejected", error);
+    std::ofstream verdicts(inbox / "verdicts.txt", std::ios::app);
+    if (error || !verdicts) {
+        logger.write(LOG_ERROR, "Cannot use %s as an inbox", inbox.string().c_str());
+        return 1;
+    }
+
+    ReplayVerifier verifier(threads, queue);
+    logger.write(LOG_INFO, "Verifying replays dropped into %s on %d threads", inbox.string().c_str(), verifier.size());
+    std::map<std::uint64_t, fs::path> inFlight;  // Submitted and not yet settled, by id
+    std::set<fs::path> queuedFiles;                // The same files, by path
+    std::set<fs::path> stuckFiles;                 // Settled but could not be moved out; never looked at again
+    std::uint64_t nextId = 0;
+    unsigned long long accepted = 0;
+    unsigned long long rejected = 0;
+
+    auto settle = [&](const fs::path& file, const VerifyResult& result) {
+        bool ok = result.status == VERIFY_ACCEPTED;
+        std::error_code moveError;
+        fs::rename(file, inbox / (ok ? "accepted" : "rejected") / file.filename(), moveError);
+        if (moveError) {
+            logger.write(LOG_ERROR, "Cannot move %s out of the inbox: %s", file.filename().string().c_str(), moveError.message().c_str());
+            stuckFiles.insert(file);
+        }
+        verdicts << file.filename().string() << ' ' << verifyStatusName(result.status) << ' ' << result.claimedScore << ' '
+            << result.score << '\n';
+        verdicts.flush();
+        (ok ? accepted : rejected)++;
+        if (!ok) {
+            logger.write(LOG_WARNING, "Rejected %s: %s, claimed %d, scored %d", file.filename().string().c_str(),
+                verifyStatusName(result.status), result.claimedScore, result.score);
+        }
+    };
+    auto collect = [&]() {
+        VerifyResult result;
+        while (verifier.poll(result)) {
+            settle(inFlight[result.id], result);
+            queuedFiles.erase(inFlight[result.id]);
+            inFlight.erase(result.id);
+        }
+    };
+
+    for (;;) {
+        int found = 0;
+        for (const fs::directory_entry& entry : fs::directory_iterator(inbox, error)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".bjr") {
+                continue;
+            }
+            if (queuedFiles.count(entry.path()) != 0 || stuckFiles.count(entry.path()) != 0) {
+                continue;
+            }
+            found++;
+            Replay replay;
+            if (!loadSubmission(replay, entry.path().string())) {
+                VerifyResult result = { 0, VERIFY_MALFORMED, 0, 0, 0 };
+                settle(entry.path(), result);
+                continue;
+            }
+            inFlight[nextId] = entry.path();
+            queuedFiles.insert(entry.path());
+            verifier.submit(nextId++, std::move(replay)); // Waits here while the queue is full
+            collect();
+        }
+        collect();
+        if (once && found == 0) {
+            verifier.wait();
+            collect();
+            break;
+        }
+        if (found == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+    logger.write(LOG_INFO, "%llu accepted, %llu rejected", accepted, rejected);
+    return 0;
+}
+
+// Records a few bot runs, tampers with every fourth claim, and pushes count submissions
+// through the verifier to measure how many it sustains per second
+int bench(int count, int threads, int queue) {
+    const float deltaTime = 1.f / SIM_TICK_RATE;
+    const int maxTicks = 30 * static_cast<int>(SIM_TICK_RATE);
+    std::vector<Replay> runs(16);
+    GameWorld world(0);
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        world.reset(i + 1);
+        runs[i].begin(i + 1, SIM_TICK_RATE, maxTicks);
+        for (int tick = 0; tick < maxTicks && !world.gameOver; ++tick) {
+            InputState input = botInput(world);
+            runs[i].record(input);
+            world.step(input, deltaTime);
+        }
+        runs[i].finish(world);
+    }
+
+    ReplayVerifier verifier(threads, queue);
+    int wrong = 0;
+    double simulated = 0;
+    auto check = [&]() {
+        VerifyResult result;
+        while (verifier.poll(result)) {
+            bool tampered = result.id % 4 == 3;
+            wrong += (result.status == VERIFY_ACCEPTED) == tampered ? 1 : 0;
+            simulated += result.seconds;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        Replay replay = runs[i % runs.size()];
+        if (i % 4 == 3) {
+            replay.finalScore += 10; // A claim the inputs do not back up
+        }
+        verifier.submit(i, std::move(replay));
+        check();
+    }
+    verifier.wait();
+    check();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("verified:          %d replays of up to %.0f s on %d threads\n", count, maxTicks / SIM_TICK_RATE, verifier.size());
+    std::printf("wall time:         %.3f s\n", seconds);
+    std::printf("verifications/s:   %.0f\n", seconds > 0 ? count / seconds : 0.0);
+    std::printf("mean per replay:   %.3f ms\n", count > 0 ? simulated / count * 1e3 : 0.0);
+    std::printf("wrong verdicts:    %d\n", wrong);
+    return wrong == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int threads = 0;
+    int queue = 256;
+    const char* inbox = nullptr;
+    bool once = false;
+    int benchCount = 0;
+    const char* logPath = nullptr;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+            queue = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--inbox") == 0 && i + 1 < argc) {
+            inbox = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--once") == 0) {
+            once = true;
+        }
+        else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            benchCount = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        }
+        else if (argv[i][0] != '-') {
+            files.push_back(argv[i]);
+        }
+        else {
+            std::fprintf(stderr, "Usage: %s [--threads N] [--queue N] [--log FILE] (REPLAY... | --inbox DIR [--once] | --bench N)\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (benchCount > 0) {
+        return bench(benchCount, threads, queue);
+    }
+    if (inbox) {
+        Logger logger;
+        logger.echo = true;
+        if (logPath) {
+            logger.open(logPath);
+        }
+        logger.start();
+        return serveInbox(inbox, threads, queue, once, logger);
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "Nothing to verify: give replay files, --inbox DIR or --bench N\n");
+        return 1;
+    }
+    return verifyFiles(files, threads, queue);
+}
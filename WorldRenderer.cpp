@@ -0,0 +1,67 @@
+#include "WorldRenderer.h"
+
+WorldRenderer::WorldRenderer(Resources& resources)
+    : bunnyTexture(resources.textures.get("bunny.png")),
+      saucerTexture(resources.textures.get("saucer.png")),
+      culled(0) {
+    visible.reserve(64);
+    if (bunnyTexture) {
+        bunnySprite.setTexture(*bunnyTexture);
+        bunnySprite.setScale(BUNNY_SIZE / bunnyTexture->getSize().x, BUNNY_SIZE / bunnyTexture->getSize().y);
+    }
+}
+
+void WorldRenderer::draw(sf::RenderTarget& target, const GameWorld& world, float alpha) {
+    batch.clear();
+    const sf::View& view = target.getView();
+    float viewTop = view.getCenter().y - view.getSize().y / 2;
+    float viewBottom = viewTop + view.getSize().y;
+    int drawn = 0;
+
+    world.coinGrid.query(viewTop, viewBottom, visible);
+    for (int slot : visible) {
+        const Coin& coin = world.coins[slot];
+        batch.addCircle(sf::Vector2f(coin.position.x, coin.position.y), Coin::RADIUS, sf::Color::Yellow);
+    }
+    drawn += static_cast<int>(visible.size());
+
+    // A saucer's grid band covers its power-up; the textured saucer (100 px wide, as
+    // GameWorld::addSaucer makes them) reaches further down than its 20 px hit box
+    const sf::FloatRect saucerTextureRect(SAUCER_TEXTURE_RECT);
+    const SaucerField& saucers = world.saucers;
+    float drawnHeight = saucerTexture ? 100 * saucerTextureRect.height / saucerTextureRect.width : 0;
+    world.saucerGrid.query(viewTop - drawnHeight, viewBottom, visible);
+    for (int serial : visible) {
+        int i = saucers.slot(serial);
+        sf::Vector2f saucerPosition(saucers.previousX[i] + (saucers.x[i] - saucers.previousX[i]) * alpha, saucers.y[i]);
+        if (saucerTexture) {
+            // The textured saucer keeps the sprite's proportions; its dome is the landing surface
+            float height = saucers.width[i] * saucerTextureRect.height / saucerTextureRect.width;
+            batch.addQuad(saucerTexture.get(), saucerPosition, sf::Vector2f(saucers.width[i], height),
+                sf::Vector2f(0, 0), 0, sf::Color::White, saucerTextureRect);
+        }
+        else {
+            batch.addQuad(nullptr, saucerPosition, sf::Vector2f(saucers.width[i], saucers.height[i]),
+                sf::Vector2f(0, 0), 0, sf::Color::Black);
+        }
+    }
+
+    for (int serial : visible) {
+        int slot = saucers.powerUp[saucers.slot(serial)];
+        if (slot >= 0 && world.powerUps[slot].isActive) {
+            const PowerUp& powerUp = world.powerUps[slot];
+            Vec2 powerUpPosition = lerp(powerUp.previousPosition, powerUp.position, alpha);
+            batch.addQuad(nullptr, sf::Vector2f(powerUpPosition.x, powerUpPosition.y), sf::Vector2f(30, 30),
+                sf::Vector2f(15, 15), powerUp.rotation, sf::Color::Blue);
+            drawn++;
+        }
+    }
+    drawn += static_cast<int>(visible.size());
+    culled = world.coins.size() + saucers.size() + world.powerUps.size() - drawn;
+
+    batch.drawTo(target);
+
+    Vec2 bunnyPosition = lerp(world.bunny.previousPosition, world.bunny.position, alpha);
+    bunnySprite.setPosition(bunnyPosition.x, bunnyPosition.y);
+    target.draw(bunnySprite);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "GameWorld.h"
+#include "ResourceCache.h"
+#include "SpriteBatch.h"
+
+const sf::IntRect SAUCER_TEXTURE_RECT(470, 390, 500, 310); // The saucer inside saucer.png
+
+// Draws the world state. Holds on to its textures through cache handles, so it can be
+// copied or rebuilt on retry without touching the disk again. Saucers, coins and
+// power-ups go through a SpriteBatch: one draw call per texture instead of per entity.
+// Only entities in the target's current view are batched, found through the world's
+// spatial grids, so drawing costs the same however much of the level is loaded.
+class WorldRenderer {
+public:
+    ResourceCache<sf::Texture>::Handle bunnyTexture;
+    ResourceCache<sf::Texture>::Handle saucerTexture;
+    sf::Sprite bunnySprite;
+    SpriteBatch batch;
+    std::vector<int> visible;  // Scratch list of grid query results
+    int culled;                // Entities the last draw left out
+
+    explicit WorldRenderer(Resources& resources);
+
+    // Draws the world as it was alpha of the way from the previous tick to the current one
+    void draw(sf::RenderTarget& target, const GameWorld& world, float alpha);
+};
@@ -1,24 +1,23 @@
 #include <SFML/Graphics.hpp>
+#include <chrono>
 #include <iostream>
 #include <vector>
-#include <random>
 #include <string>
 #include <cmath>
-#include <chrono>
-using namespace std::chrono;
-
-
-enum GameState {
-    MAIN_MENU,
-    GAME_PLAY,
-    GAME_OVER
-};
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "GameWorld.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "ResourceCache.h"
+#include "WorldRenderer.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "Hud.h"
+#include "Leaderboard.h"
+#include "Logger.h"
 
-enum PowerUpType {
-    SUPER_JUMP,
-    SPEED_BOOST,
-    MAGNET
-};
 
 class Button {
 public:
@@ -50,266 +49,98 @@ public:
     }
 };
 
-class GameStats {
-public:
-    int score;           // Current score
-    int highScore;       // High score during the session
-    int saucersJumped;   // Count of saucers the bunny has jumped on
-
-    GameStats() : score(0), highScore(0), saucersJumped(0) {}
-
-    void addScore(int points) {
-        score += points;
-        if (score > highScore) {
-            highScore = score;  // Update high score if current score is greater
+int main(int argc, char** argv) {
+    auto launch = std::chrono::steady_clock::now(); // Cold start is timed from here to the first frame shown
+    float tickRate = SIM_TICK_RATE;
+    float fpsLimit = 120;      // Gameplay frame rate; 0 renders as fast as possible
+    bool vsync = false;        // Let the display pace gameplay instead
+    std::uint64_t seed = std::random_device()(); // Pass --seed to replay a level
+    const char* recordPath = nullptr;  // Save each run's inputs here
+    const char* replayPath = nullptr;  // Play this recording instead of reading the keyboard
+    const char* profilePath = nullptr; // Dump frame timings here on exit (.json for a Chrome trace, CSV otherwise)
+    const char* scoresPath = "scores";  // Leaderboard files, scores.log and scores.idx
+    const char* assetsPath = "assets.pak"; // Packed assets; loose files are used when it is missing
+    const char* logPath = "bunny.log";     // Rotated to bunny.log.1 and so on as it fills
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = static_cast<float>(std::atof(argv[++i]));
         }
-    }
-
-    void jumpedSaucer() {
-        saucersJumped++;
-        addScore(10);  // Adds 10 points for every saucer jumped
-    }
-
-    void reset() {
-        score = 0;
-        saucersJumped = 0;
-    }
-};
-
-
-class Bunny {
-public:
-    sf::Sprite sprite;
-    sf::Texture texture;
-    sf::Vector2f velocity;
-    bool superJumpActive;
-    float superJumpTimer;
-    bool speedBoostActive;
-    float speedBoostTimer;
-    bool magnetActive;
-    float magnetTimer;
-    bool onSaucerLastFrame;
-
-
-    Bunny(float x, float y) : superJumpActive(false), superJumpTimer(0),
-        speedBoostActive(false), speedBoostTimer(0),
-        magnetActive(false), magnetTimer(0),
-        onSaucerLastFrame(false) { 
-        if (!texture.loadFromFile("bunny.png")) {
-            std::cerr << "Failed to load bunny.png" << std::endl;
+        else if (std::strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc) {
+            fpsLimit = static_cast<float>(std::atof(argv[++i]));
         }
-        sprite.setTexture(texture);
-        sprite.setPosition(x, y);
-        sprite.setScale(0.1f, 0.1f);
-        velocity = sf::Vector2f(0, 0);
-    }
-    void update(bool onSaucer, float deltaTime) {
-        const float gravity = 980.0f; // Increased gravity for more realistic physics
-        velocity.y += gravity * deltaTime; // Apply gravity to vertical velocity
-
-        // Check for power-ups effects
-        if (superJumpActive && superJumpTimer > 0) {
-            superJumpTimer -= deltaTime;
-            if (superJumpTimer <= 0) superJumpActive = false;
+        else if (std::strcmp(argv[i], "--vsync") == 0) {
+            vsync = true;
         }
-
-        if (speedBoostActive && speedBoostTimer > 0) {
-            speedBoostTimer -= deltaTime;
-            if (speedBoostTimer <= 0) {
-                speedBoostActive = false;
-                velocity.x /= 0.5; // Reset speed back to normal when boost ends
-            }
-        }
-
-        if (magnetActive && magnetTimer > 0) {
-            magnetTimer -= deltaTime;
-            if (magnetTimer <= 0) magnetActive = false;
-        }
-
-        if (onSaucer && sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
-            jump();
-        }
-
-        // Adjust horizontal velocity based on current state of speed boost and keyboard input
-        float baseSpeed = 300.f; // Base speed
-        float currentSpeed = speedBoostActive ? baseSpeed * 2.0f : baseSpeed; // Apply boost
-
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) {
-            velocity.x = -currentSpeed;
-        }
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) {
-            velocity.x = currentSpeed;
-        }
-        else {
-            velocity.x = 0; // No horizontal input means no horizontal movement
-        }
-
-        // Apply the calculated velocity to update position
-        sprite.move(velocity.x * deltaTime, velocity.y * deltaTime); // Correctly apply deltaTime here
-    }
-
-    void jump() {
-        if (superJumpActive) {
-            velocity.y = -900.f; // Increased jump height for super jump
-        }
-        else {
-            velocity.y = -600.f; // Normal jump height
-        }
-    }
-
-
-    void drawTo(sf::RenderWindow& window) {
-        window.draw(sprite);
-    }
-};
-class PowerUp {
-public:
-    sf::RectangleShape shape;
-    PowerUpType type;
-    bool isActive;
-
-    PowerUp(PowerUpType type, float x, float y) : type(type), isActive(true) {
-        shape.setSize(sf::Vector2f(30, 30)); // Size of the power-up
-        shape.setFillColor(sf::Color::Blue); // Blue color for visibility
-        shape.setPosition(x, y);
-        shape.setOrigin(15, 15); // Set origin for rotation
-    }
-
-    void update(float deltaTime) {
-        shape.rotate(90 * deltaTime); // Rotating effect, 90 degrees per second
-    }
-
-    void drawTo(sf::RenderWindow& window) {
-        if (isActive) {
-            window.draw(shape);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
         }
-    }
-
-    void activate(Bunny& bunny, std::string& currentPowerUpName, float& powerUpMessageTimer) {
-        isActive = false; // Mark as consumed
-        switch (type) {
-        case SUPER_JUMP:
-            bunny.superJumpActive = true;
-            bunny.superJumpTimer = 5.0; // Active for 5 seconds
-            currentPowerUpName = "Super Jump";
-            std::cout << "Activated Super Jump\n";
-            break;
-        case SPEED_BOOST:
-            bunny.speedBoostActive = true;
-            bunny.velocity.x *= 10.5;
-            bunny.speedBoostTimer = 5.0;
-            currentPowerUpName = "Speed Boost";
-            std::cout << "Activated Speed Boost\n";
-            break;
-        case MAGNET:
-            bunny.magnetActive = true;
-            bunny.magnetTimer = 5.0;
-            currentPowerUpName = "Magnet";
-            std::cout << "Activated Magnet\n";
-            // Implement magnet logic if applicable
-            break;
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
         }
-        powerUpMessageTimer = 2.0; // Display message for 2 seconds
-    }
-};
-class FlyingSaucer {
-public:
-    sf::RectangleShape shape;
-    float speed;
-    bool hasPowerUp;
-    std::vector<PowerUp> powerUps;
-
-    FlyingSaucer(float x, float y, float width, float height) : speed(-0.5), hasPowerUp(false) {
-        shape.setPosition(x, y);
-        shape.setSize(sf::Vector2f(width, height));
-        shape.setFillColor(sf::Color::Black);
-    }
-
-    void update(float deltaTime) {
-        float actualSpeed = speed * deltaTime; // Adjust speed by deltaTime
-        shape.move(actualSpeed, 0); // Move saucer horizontally
-
-        // Update power-up positions to move with the saucer
-        for (auto& powerUp : powerUps) {
-            powerUp.shape.setPosition(shape.getPosition().x + shape.getSize().x / 2 - 15, shape.getPosition().y - 30);
-            powerUp.update(deltaTime); // Update rotation with deltaTime
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
         }
-
-        // Reverse direction at screen boundaries
-        if (shape.getPosition().x + shape.getSize().x < 0 && speed < 0) {
-            speed = -speed;
-            shape.setPosition(0, shape.getPosition().y);
+        else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
         }
-        else if (shape.getPosition().x > 800 && speed > 0) {
-            speed = -speed;
-            shape.setPosition(800 - shape.getSize().x, shape.getPosition().y);
+        else if (std::strcmp(argv[i], "--scores") == 0 && i + 1 < argc) {
+            scoresPath = argv[++i];
         }
-    }
-
-
-    void drawTo(sf::RenderWindow& window) {
-        window.draw(shape);
-        for (auto& powerUp : powerUps) {
-            powerUp.drawTo(window);
+        else if (std::strcmp(argv[i], "--assets") == 0 && i + 1 < argc) {
+            assetsPath = argv[++i];
         }
-    }
-
-    void spawnPowerUpOnSaucer() {
-        if (!hasPowerUp) { // Only spawn a power-up if there isn't already one
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, 2); // Random type from 0 to 2
-            PowerUpType randomType = static_cast<PowerUpType>(dis(gen));
-            float x = shape.getPosition().x + shape.getSize().x / 2 - 15; // Centered on the saucer
-            float y = shape.getPosition().y - 30; // Above the saucer
-            powerUps.emplace_back(randomType, x, y);
-            hasPowerUp = true;
+        else if (std::strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
         }
     }
-};
-class Coin {
-public:
-    sf::CircleShape shape;  // Using CircleShape for a coin appearance
-    bool isActive;
-
-    Coin(float x, float y) : isActive(true) {
-        shape.setRadius(15); // Size of the coin
-        shape.setFillColor(sf::Color::Yellow); // Coin color
-        shape.setPosition(x, y);
+    if (tickRate <= 0) {
+        tickRate = SIM_TICK_RATE;
     }
 
-    void drawTo(sf::RenderWindow& window) {
-        if (isActive) {
-            window.draw(shape);
+    // Messages from inside the loop are queued and written out by the logger's thread, so
+    // a slow terminal or disk never holds up a frame
+    Logger logger;
+    logger.echo = true;
+    logger.setRateLimit(20, 50);
+    logger.open(logPath);
+    logger.start();
+
+    Replay replay;
+    bool playback = false;
+    std::size_t replayTick = 0;
+    if (replayPath) {
+        if (!replay.load(replayPath)) {
+            return -1;
         }
+        seed = replay.seed;
+        tickRate = replay.tickRate;  // A replay only reproduces at the rate it was recorded at
+        playback = true;
     }
 
-    bool checkCollision(const sf::FloatRect& bunnyBounds) {
-        return shape.getGlobalBounds().intersects(bunnyBounds);
-    }
-};
-
-int main() {
     sf::RenderWindow window(sf::VideoMode(800, 600), "Bunny Jumper", sf::Style::Close);
+    window.setVerticalSyncEnabled(vsync);
     window.clear(sf::Color::White); // Set background to white
 
     sf::Clock clock;
-
-    sf::Font font;
-    if (!font.loadFromFile("pixel-font.ttf")) {
-        std::cout << "Could not load font\n";
+    FramePacer pacer(vsync ? 0 : fpsLimit);
+    bool redraw = true; // The menu and game-over screens are only drawn again when this is set
+    FixedTimestep timestep(tickRate);
+
+    Resources resources;
+    bool packedAssets = resources.openArchive(assetsPath);
+    ResourceCache<sf::Font>::Handle fontHandle = resources.fonts.get("pixel-font.ttf");
+    if (!fontHandle) {
+        logger.write(LOG_ERROR, "Could not load font");
         return -1;
     }
+    sf::Font& font = *fontHandle;
+
+    WorldRenderer worldRenderer(resources);
 
     sf::Text title("Bunny Jumper", font, 50);
     title.setFillColor(sf::Color::Black); // Black color
     title.setPosition(275, 50);
 
-    Bunny bunny(375, 300);
-
-    std::vector<Coin> coins; // Move coins vector to be accessible in the entire main function
-    auto lastCoinSpawnTime = std::chrono::steady_clock::now(); // Initialize the last coin spawn time
-
     Button playButton("Play", font, 30, sf::Vector2f(300, 200), sf::Vector2f(200, 50));
     Button exitButton("Exit", font, 30, sf::Vector2f(300, 300), sf::Vector2f(200, 50));
     Button shopButton("Shop", font, 30, sf::Vector2f(300, 400), sf::Vector2f(200, 50));
@@ -320,130 +151,192 @@ int main() {
 
     Button retryButton("Try Again", font, 30, sf::Vector2f(300, 350), sf::Vector2f(200, 50));
 
-    sf::Text scoreText;
-    scoreText.setFont(font);
-    scoreText.setCharacterSize(24);
-    scoreText.setFillColor(sf::Color::Black);
-    scoreText.setPosition(10, 10);  // Position at top-left corner of the window
-
-    sf::Text highScoreText;
-    highScoreText.setFont(font);
-    highScoreText.setCharacterSize(24);
-    highScoreText.setFillColor(sf::Color::Black);
-    highScoreText.setPosition(650, 10);  // Position at top-right corner of the window
-
-    sf::Text powerUpMessage;
-    float powerUpMessageTimer = 0;
-    std::string currentPowerUpName = "";
-
-    // Setup in the initialization section
-    powerUpMessage.setFont(font);
-    powerUpMessage.setCharacterSize(24);
-    powerUpMessage.setFillColor(sf::Color::White);
-    powerUpMessage.setPosition(400, 300); // Center on screen
-
-    sf::Text heightText;
-    heightText.setFont(font);
-    heightText.setCharacterSize(24);
-    heightText.setFillColor(sf::Color::Black);
-
-    GameStats stats;
-
-    std::vector<FlyingSaucer> saucers;
-    // Initial saucer positioning
-    saucers.push_back(FlyingSaucer(200, 500, 100, 20));
-    saucers.push_back(FlyingSaucer(500, 350, 100, 20));
-    saucers.push_back(FlyingSaucer(300, 200, 100, 20));
-
-
-    // Variables to track saucer spawning
-    float minHeight = 600; // Track the minimum height (highest point) the bunny has reached
-    float spawnHeight = 200; // Initial height for the first saucer above the screen view
-
-    auto lastPowerUpSpawnTime = steady_clock::now();
+    sf::Text rankText("", font, 20);
+    rankText.setFillColor(sf::Color::Black);
+    rankText.setPosition(300, 315);
+
+    // Best runs on the main menu, rebuilt only when the board changes
+    sf::Text leaderboardText("", font, 20);
+    leaderboardText.setFillColor(sf::Color::Black);
+    leaderboardText.setPosition(560, 200);
+    unsigned int shownLeaderboard = 0;
+
+    Hud hud(font);
+
+    // F3 toggles the profiler overlay; its text is rebuilt a few times a second
+    sf::Text profilerText;
+    profilerText.setFont(font);
+    profilerText.setCharacterSize(14);
+    profilerText.setFillColor(sf::Color(160, 0, 0));
+    bool showProfiler = false;
+    PhaseStats phaseStats[PHASE_COUNT];
+
+    Profiler profiler;
+
+    GameWorld world(seed);
+    logger.write(LOG_INFO, "Seed: %llu", static_cast<unsigned long long>(seed));
+    world.logger = &logger;
+    world.profiler = &profiler;
+
+    // Generate the level ahead of the camera on a worker, so climbing never waits on it
+    world.streamer.start();
+    world.streamer.restart(world.levelSeed, world.nextChunk);
+
+    // Finished runs are written to disk on the leaderboard's own thread; the session high
+    // score starts from the best run on the board
+    Leaderboard leaderboard;
+    if (leaderboard.open(scoresPath)) {
+        leaderboard.start();
+        world.stats.highScore = leaderboard.best();
+    }
 
-    GameState currentState = MAIN_MENU;
+    GameState currentState = playback ? GAME_PLAY : MAIN_MENU;
+    std::uint64_t runSeed = seed;
+    bool runSaved = false;
+    if (recordPath) {
+        replay.begin(runSeed, tickRate, 10 * 60 * static_cast<std::size_t>(tickRate));
+    }
 
     while (window.isOpen()) {
-        auto now = steady_clock::now();
-        auto timeSinceLastPowerUp = duration_cast<seconds>(now - lastPowerUpSpawnTime).count();
-
-        if (timeSinceLastPowerUp >= 5) { // Check if 5 seconds have elapsed
-            // Find the highest saucer that doesn't have a power-up
-            FlyingSaucer* highestSaucer = nullptr;
-            for (auto& saucer : saucers) {
-                if (!saucer.hasPowerUp && (highestSaucer == nullptr || saucer.shape.getPosition().y < highestSaucer->shape.getPosition().y)) {
-                    highestSaucer = &saucer;
-                }
-            }
-            if (highestSaucer) {
-                highestSaucer->spawnPowerUpOnSaucer();
-                lastPowerUpSpawnTime = now; // Reset the timer
-            }
+        // Nothing on a static screen changes without input, so sleep until some arrives
+        // instead of redrawing the same frame
+        sf::Event event;
+        bool haveEvent = false;
+        if (currentState != GAME_PLAY && !redraw) {
+            haveEvent = window.waitEvent(event);
+            clock.restart();
+            pacer.restart(); // The idle stretch is not a frame
         }
+
+        profiler.beginFrame();
+        ProfileScope frame(&profiler, PHASE_FRAME);
+        ProfileScope phase(&profiler, PHASE_EVENTS);
+
         sf::Time elapsed = clock.restart(); // Restart the clock and get elapsed time
         float deltaTime = elapsed.asSeconds();
 
-        scoreText.setString("Score: " + std::to_string(stats.score));
-        highScoreText.setString("High Score: " + std::to_string(stats.highScore));
-        window.draw(scoreText);
-        window.draw(highScoreText);
+        if (!haveEvent) {
+            haveEvent = window.pollEvent(event);
+        }
+        for (; haveEvent; haveEvent = window.pollEvent(event)) {
+            if (event.type != sf::Event::MouseMoved) {
+                redraw = true; // Nothing on the static screens reacts to the pointer alone
+            }
 
-        sf::Event event;
-        while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+                showProfiler = !showProfiler;
+            }
+
             if (event.type == sf::Event::MouseButtonPressed) {
                 if (currentState == MAIN_MENU) {
                     if (playButton.isMouseOver(window)) {
+                        timestep.reset();
                         currentState = GAME_PLAY; // Change state to gameplay
                     }
-                    if (currentState == GAME_OVER) {
-                        if (retryButton.isMouseOver(window)) {
-                            // Reset everything and start new game
-                            currentState = GAME_PLAY;
-                        }
-                    }
                     if (exitButton.isMouseOver(window)) {
                         window.close();
                     }
                     if (shopButton.isMouseOver(window)) {
-                        std::cout << "Open Shop\n"; // Placeholder for shop
+                        logger.write(LOG_INFO, "Open Shop"); // Placeholder for shop
+                    }
+                }
+                else if (currentState == GAME_OVER) {
+                    if (retryButton.isMouseOver(window)) {
+                        // Reset game stats and positions, keeping the session high score
+                        // Each run gets its own seed so it can be recorded and replayed on its own
+                        int highScore = world.stats.highScore;
+                        world.reset(++runSeed);
+                        world.stats.highScore = highScore;
+                        timestep.reset();
+                        currentState = GAME_PLAY;
+                        playback = false;
+                        runSaved = false;
+                        if (recordPath) {
+                            replay.begin(runSeed, tickRate, 10 * 60 * static_cast<std::size_t>(tickRate));
+                        }
                     }
                 }
             }
         }
-        // Random device for saucer spawning
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(100, 700); // Saucer spawning positions
 
+        phase.switchTo(PHASE_SIMULATION);
+        if (currentState == GAME_PLAY) {
+            InputState input;
+            input.jump = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+            input.left = sf::Keyboard::isKeyPressed(sf::Keyboard::A);
+            input.right = sf::Keyboard::isKeyPressed(sf::Keyboard::D);
+
+            // Simulation runs in fixed ticks; rendering interpolates between the last two
+            int ticks = timestep.advance(deltaTime);
+            for (int tick = 0; tick < ticks && !world.gameOver; ++tick) {
+                if (playback) {
+                    if (replayTick == replay.inputs.size()) {
+                        break;
+                    }
+                    input = unpackInput(replay.inputs[replayTick++]);
+                }
+                else if (recordPath) {
+                    replay.record(input);
+                }
+                world.step(input, timestep.tickDuration);
+            }
 
-        float lastY = 300; // Initial position for dynamic spawning
+            if (playback && replayTick == replay.inputs.size() && !runSaved) {
+                if (replay.matches(world)) {
+                    logger.write(LOG_INFO, "Replay finished: stats match the recording");
+                }
+                else {
+                    logger.write(LOG_WARNING, "Replay finished: stats DIFFER from the recording");
+                }
+                runSaved = true;
+                if (!world.gameOver) {
+                    // The recording stopped mid-run, e.g. its window was closed: rather than
+                    // leave the world frozen, end on the game over screen so Retry starts a new run
+                    rankText.setString("");
+                    currentState = GAME_OVER;
+                    redraw = true;
+                }
+            }
+        }
 
-        // Calculate height based on some reference point, e.g., initial bunny position or screen bottom
-        float currentHeight = window.getSize().y - bunny.sprite.getPosition().y;  // Assuming (0,0) is at the top
+        // A recording ends with its run, or when the window closes mid-run
+        bool runEnded = world.gameOver || !window.isOpen();
+        if (recordPath && !playback && !runSaved && runEnded && currentState != MAIN_MENU) {
+            replay.finish(world);
+            if (replay.save(recordPath)) {
+                logger.write(LOG_INFO, "Saved replay of seed %llu to %s", static_cast<unsigned long long>(replay.seed), recordPath);
+            }
+            runSaved = true;
+        }
 
-        // Set the string for the height text
-        heightText.setString("Height: " + std::to_string(static_cast<int>(currentHeight)) + " units");
-        if (currentHeight <= 0.0f) {
+        if (world.gameOver && currentState == GAME_PLAY) {
+            if (!playback && leaderboard.isOpen()) {
+                char line[64] = "";
+                int place = leaderboard.rankOf(world.stats.score);
+                if (place > 0) {
+                    std::snprintf(line, sizeof(line), "Place %d of %llu runs", place, static_cast<unsigned long long>(leaderboard.runs() + 1));
+                }
+                rankText.setString(line);
+                leaderboard.submit(finishedRun(world, runSeed));
+            }
             currentState = GAME_OVER;
-            std::cout << "Game Over: below 0 height" << std::endl;
+            redraw = true;
+            logger.write(LOG_INFO, "Game Over: below 0 height with score %d", world.stats.score);
+        }
+        if (currentState != GAME_PLAY && !redraw) {
+            continue; // Only pointer movement since the last frame: keep what is on screen
         }
+        redraw = false;
+
+        phase.switchTo(PHASE_RENDER);
         window.clear(sf::Color::White);
         if (currentState == GAME_OVER) {
             window.draw(gameOverText);
+            window.draw(rankText);
             retryButton.drawTo(window);
-
-            if (event.type == sf::Event::MouseButtonPressed) {
-                if (retryButton.isMouseOver(window)) {
-                    // Reset game stats and positions
-                    stats.reset();
-                    bunny = Bunny(375, 300); // Reset bunny position
-                    currentState = GAME_PLAY;
-                }
-            }
         }
 
         else if (currentState == MAIN_MENU) {
@@ -451,130 +344,82 @@ int main() {
             playButton.drawTo(window);
             exitButton.drawTo(window);
             shopButton.drawTo(window);
-        }
-        else if (currentState == GAME_PLAY) {
-            bool onSaucer = false;
-            // Minimum height calculation needs resetting every frame
-            float currentMinHeight = minHeight;
-
-            // Coin spawning logic
-            auto timeSinceLastCoin = std::chrono::duration_cast<std::chrono::seconds>(now - lastCoinSpawnTime).count();
-            if (timeSinceLastCoin >= 10) { // Spawn coin every 10 seconds
-                std::uniform_real_distribution<> disX(0, window.getSize().x - 30); // Adjust to prevent spawn outside the view
-                float newY = bunny.sprite.getPosition().y - 200; // Coins spawn above the bunny
-                coins.emplace_back(disX(gen), newY);
-                lastCoinSpawnTime = now; // Reset the timer after spawning a coin
-            }
 
-            // Update and draw coins
-            for (auto& coin : coins) {
-                if (coin.isActive && coin.checkCollision(bunny.sprite.getGlobalBounds())) {
-                    coin.isActive = false; // Coin collected
-                    stats.score += 200; // Add points for collecting a coin
+            if (leaderboard.version() != shownLeaderboard) {
+                shownLeaderboard = leaderboard.version();
+                RunRecord best[5];
+                int count = leaderboard.top(best, 5);
+                std::string table = count > 0 ? "Best runs\n" : "";
+                char line[32];
+                for (int i = 0; i < count; ++i) {
+                    std::snprintf(line, sizeof(line), "%d. %d\n", i + 1, best[i].score);
+                    table += line;
                 }
-                coin.drawTo(window);
-            }
-
-            // Clean up inactive coins to free memory
-            coins.erase(std::remove_if(coins.begin(), coins.end(), [](const Coin& coin) {
-                return !coin.isActive;
-                }), coins.end());
-
-            for (auto& saucer : saucers) {
-                saucer.update(0.5);
-                saucer.drawTo(window);
-                bool isOnCurrentSaucer = bunny.sprite.getGlobalBounds().intersects(saucer.shape.getGlobalBounds()) && bunny.velocity.y >= 0;
-                if (isOnCurrentSaucer) {
-                    bunny.velocity.y = 0;
-                    bunny.sprite.setPosition(bunny.sprite.getPosition().x, saucer.shape.getPosition().y - bunny.sprite.getGlobalBounds().height);
-                    if (!bunny.onSaucerLastFrame) {
-                        stats.jumpedSaucer(); // Only call this when first landing on a saucer
-                    }
-                    onSaucer = true;
-
-                    currentMinHeight = std::min(currentMinHeight, saucer.shape.getPosition().y);
-                }
-                for (auto& powerUp : saucer.powerUps) {
-                    powerUp.update(deltaTime);
-                    if (powerUp.isActive && powerUp.shape.getGlobalBounds().intersects(bunny.sprite.getGlobalBounds())) {
-                        powerUp.activate(bunny, currentPowerUpName, powerUpMessageTimer);
-                    }
-                }
-
-            }
-            // After all saucers have been processed, update the onSaucerLastFrame
-            bunny.onSaucerLastFrame = onSaucer;
-
-            // If the bunny is no longer on any saucer, reset the onSaucer flag
-            if (!onSaucer) {
-                bunny.onSaucerLastFrame = false;
-            }
-
-            if (powerUpMessageTimer > 0) {
-                powerUpMessageTimer -= deltaTime;
-                powerUpMessage.setString(currentPowerUpName + " Activated!");
-            }
-            else {
-                powerUpMessage.setString("");
-
+                leaderboardText.setString(table);
             }
-
-            bunny.update(onSaucer, deltaTime);
-            bunny.drawTo(window);
-
-            if (currentMinHeight < minHeight) {
-                minHeight = currentMinHeight;
-                // Spawn new saucers progressively higher as the bunny ascends
-                spawnHeight = minHeight - 100; // Adjust spawn height based on the new minHeight
-                saucers.push_back(FlyingSaucer(dis(gen), spawnHeight, 100, 20));
-            }
-
-            // Remove off-screen saucers
-            saucers.erase(std::remove_if(saucers.begin(), saucers.end(), [&](const FlyingSaucer& s) {
-                return s.shape.getPosition().y > window.getSize().y;
-                }), saucers.end());
-
+            window.draw(leaderboardText);
+        }
+        else if (currentState == GAME_PLAY) {
             // Adjust the view to follow the bunny if it moves up
-            if (bunny.sprite.getPosition().y < 300) {
-                window.setView(sf::View(sf::FloatRect(0, bunny.sprite.getPosition().y - 300, 800, 600)));
-            }
-            // Update score and high score positions according to the view
-            sf::View currentView = window.getView();
-            scoreText.setPosition(currentView.getCenter().x - 390, currentView.getCenter().y - 290);
-            highScoreText.setPosition(currentView.getCenter().x + 250, currentView.getCenter().y - 290);
-
-            // Update power-up message position and text according to the view
-            if (powerUpMessageTimer > 0) {
-                powerUpMessageTimer -= deltaTime;
-                powerUpMessage.setString(currentPowerUpName + " Activated!");
-                powerUpMessage.setPosition(currentView.getCenter().x - powerUpMessage.getLocalBounds().width / 2, currentView.getCenter().y - 300); // Center at the top of the screen
-            }
-            else {
-                powerUpMessage.setString(""); // Clear the message when the timer is done
-            }
+            float alpha = timestep.alpha();
+            float viewTop = world.previousViewTop + (world.viewTop - world.previousViewTop) * alpha;
+            window.setView(sf::View(sf::FloatRect(0, viewTop, 800, 600)));
 
-            // Ensure to draw the power-up message last so it appears over other elements
-            window.draw(powerUpMessage);
+            worldRenderer.draw(window, world, alpha);
         }
-        // Update score display based on current view
+
+        // The HUD goes on top of everything, following the current view
+        phase.switchTo(PHASE_HUD);
+        hud.update(world);
+        hud.draw(window, currentState == GAME_PLAY);
         sf::View currentView = window.getView();
-        scoreText.setPosition(currentView.getCenter().x - 390, currentView.getCenter().y - 290);
-        highScoreText.setPosition(currentView.getCenter().x + 150, currentView.getCenter().y - 290);
-        heightText.setPosition(currentView.getCenter().x - 390, currentView.getCenter().y - 250);
 
-        scoreText.setString("Score: " + std::to_string(stats.score));
-        highScoreText.setString("High Score: " + std::to_string(stats.highScore));
-        window.draw(scoreText);
-        window.draw(highScoreText);
-        window.draw(heightText);
+        if (showProfiler) {
+            if (profiler.currentFrame() % 15 == 0) {
+                profiler.summarize(phaseStats);
+                std::string report = "phase          p50 ms   p99 ms   max ms\n";
+                char line[128];
+                for (int i = 0; i < PHASE_COUNT; ++i) {
+                    std::snprintf(line, sizeof(line), "%-12s %8.3f %8.3f %8.3f\n", phaseName(static_cast<ProfilePhase>(i)),
+                        phaseStats[i].p50, phaseStats[i].p99, phaseStats[i].max);
+                    report += line;
+                }
+                std::snprintf(line, sizeof(line), "coins %d  saucers %d  power-ups %d  culled %d  draw calls %d  hud rebuilds %u",
+                    world.coins.size(), world.saucers.size(), world.powerUps.size(), worldRenderer.culled, static_cast<int>(worldRenderer.batch.drawCalls()), hud.rebuilds);
+                report += line;
+                FrameTimeStats frameTimes = pacer.stats();
+                std::snprintf(line, sizeof(line), "\nframe interval mean %.2f ms  p99 %.2f ms  late %llu",
+                    frameTimes.mean, frameTimes.p99, frameTimes.late);
+                report += line;
+                profilerText.setString(report);
+            }
+            profilerText.setPosition(currentView.getCenter().x - 390, currentView.getCenter().y - 210);
+            window.draw(profilerText);
+        }
 
         // Reset view when going back to main menu
         if (currentState == MAIN_MENU) {
             window.setView(sf::View(sf::FloatRect(0, 0, 800, 600)));
         }
 
+        phase.switchTo(PHASE_DISPLAY);
+        if (currentState == GAME_PLAY) {
+            pacer.wait();
+        }
         window.display();
+
+        if (launch != std::chrono::steady_clock::time_point()) {
+            double startup = std::chrono::duration<double>(std::chrono::steady_clock::now() - launch).count();
+            logger.write(LOG_INFO, "Cold start: %.1f ms to the first frame, assets from %s", startup * 1e3, packedAssets ? assetsPath : "loose files");
+            launch = std::chrono::steady_clock::time_point();
+        }
     }
 
+    logger.stop(); // Flush what the loop logged before the summary below
+    resources.printStats(std::cout);
+    pacer.printStats(std::cout);
+    if (profilePath && profiler.save(profilePath)) {
+        std::cout << "Saved frame profile to " << profilePath << "\n";
+    }
     return 0;
 }